@@ -17,6 +17,7 @@
 #include "core/base/jutil.h"
 
 #include "core/base/logging.h"
+#include "core/base/mutex_locker.h"
 #include "core/base/utils.h"
 #include "core/setting/settings.h"
 
@@ -103,6 +104,7 @@ pbnjson::JSchema JUtil::loadSchema(const std::string& schemaName, bool cache)
 
     if (cache)
     {
+        MutexLocker lock(&m_schemaMutex);
         auto it = m_mapSchema.find(schemaName);
         if (it != m_mapSchema.end())
             return it->second;
@@ -115,6 +117,7 @@ pbnjson::JSchema JUtil::loadSchema(const std::string& schemaName, bool cache)
 
     if (cache)
     {
+        MutexLocker lock(&m_schemaMutex);
         m_mapSchema.insert( std::pair< std::string, pbnjson::JSchema >(schemaName, schema) );
     }
 
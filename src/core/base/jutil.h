@@ -21,6 +21,7 @@
 #include <string>
 #include <map>
 
+#include "core/base/mutex.h"
 #include "core/base/singleton.h"
 
 //! List of utilites for pbnjson
@@ -94,6 +95,8 @@ protected:
     ~JUtil();
 
 private:
+    //! Guards schema cache, since app scanning parses files in worker threads
+    Mutex m_schemaMutex;
     std::map< std::string, pbnjson::JSchema > m_mapSchema;
 };
 #endif /* JUTIL_H */
@@ -96,12 +96,16 @@
 #define MSGID_NATIVE_APP_HANDLER            "NATIVE_APP_HANDLER" /** all list handled by native app handlers */
 #define MSGID_NATIVE_APP_LIFE_CYCLE_EVENT   "NATIVE_APP_LIFE_CYCLE_EVENT" /** native app life cycle event */
 #define MSGID_NATIVE_CLIENT_INFO            "NATIVE_CLIENT_INFO"
+#define MSGID_NATIVE_APP_CGROUP             "NATIVE_APP_CGROUP" /** cgroup of native app processes */
+#define MSGID_LAUNCH_ZYGOTE                 "LAUNCH_ZYGOTE" /** pre-forked launcher of native apps */
+#define MSGID_MEMORY_RECLAIM                "MEMORY_RECLAIM" /** closing background apps for memory */
 #define MSGID_HANDLE_CRIU                   "HANDLE_CRIU"
 
 /* app package */
 #define MSGID_START_SCAN                    "START_SCAN" /** START SCANNING with locale info */
 #define MSGID_APP_SCANNER                   "APP_SCANNER"
 #define MSGID_APPSCAN_FAIL                  "APP_SCAN_FAIL" /** Failed to scan an application */
+#define MSGID_APP_DIR_WATCHER               "APP_DIR_WATCHER" /** watching app directories changes */
 #define MSGID_PACKAGE_LOAD                  "PACKAGE_LOAD" /** package load flow */
 #define MSGID_UNINSTALL_APP                 "UNINSTALL_APP" /** uninstall app */
 #define MSGID_UNINSTALL_APP_ERR             "UNINSTALL_APP_ERR" /** uninstall app */
@@ -42,3 +42,96 @@ void Mutex::unlock()
 {
     g_rec_mutex_unlock(m_mutex);
 }
+
+RWLock::RWLock()
+    : m_writer(NULL)
+    , m_writeDepth(0)
+    , m_waitingWriters(0)
+{
+    g_mutex_init(&m_lock);
+    g_cond_init(&m_cond);
+}
+
+RWLock::~RWLock()
+{
+    g_cond_clear(&m_cond);
+    g_mutex_clear(&m_lock);
+}
+
+void RWLock::lockRead()
+{
+    GThread* self = g_thread_self();
+
+    g_mutex_lock(&m_lock);
+    if (m_writer == self) {
+        ++m_writeDepth;
+        g_mutex_unlock(&m_lock);
+        return;
+    }
+
+    // nested read doesn't wait for writers, otherwise it would deadlock with a waiting writer
+    std::map<GThread*,int>::iterator it = m_readDepth.find(self);
+    if (it == m_readDepth.end()) {
+        while (m_writer != NULL || m_waitingWriters > 0)
+            g_cond_wait(&m_cond, &m_lock);
+        m_readDepth[self] = 1;
+    } else {
+        ++(it->second);
+    }
+    g_mutex_unlock(&m_lock);
+}
+
+void RWLock::unlockRead()
+{
+    GThread* self = g_thread_self();
+
+    g_mutex_lock(&m_lock);
+    if (m_writer == self) {
+        --m_writeDepth;
+        g_mutex_unlock(&m_lock);
+        return;
+    }
+
+    std::map<GThread*,int>::iterator it = m_readDepth.find(self);
+    if (it != m_readDepth.end() && --(it->second) == 0) {
+        m_readDepth.erase(it);
+        if (m_readDepth.empty())
+            g_cond_broadcast(&m_cond);
+    }
+    g_mutex_unlock(&m_lock);
+}
+
+void RWLock::lockWrite()
+{
+    GThread* self = g_thread_self();
+
+    g_mutex_lock(&m_lock);
+    if (m_writer == self) {
+        ++m_writeDepth;
+        g_mutex_unlock(&m_lock);
+        return;
+    }
+
+    // waiting for own read lock to be released would never end
+    if (m_readDepth.find(self) != m_readDepth.end())
+        g_error("RWLock: upgrading read lock to write lock is not supported");
+
+    ++m_waitingWriters;
+    while (m_writer != NULL || !m_readDepth.empty())
+        g_cond_wait(&m_cond, &m_lock);
+    --m_waitingWriters;
+
+    m_writer = self;
+    m_writeDepth = 1;
+    g_mutex_unlock(&m_lock);
+}
+
+void RWLock::unlockWrite()
+{
+    g_mutex_lock(&m_lock);
+    if (m_writer == g_thread_self() && --m_writeDepth == 0) {
+        m_writer = NULL;
+        g_cond_broadcast(&m_cond);
+    }
+    g_mutex_unlock(&m_lock);
+}
@@ -18,6 +18,7 @@
 #define MUTEX_H
 
 #include <glib.h>
+#include <map>
 
 #include "core/base/sptr.h"
 
@@ -36,4 +37,33 @@ private:
     GRecMutex* m_mutex;
 };
 
+// Reader-writer lock. Any number of readers can hold it at the same time,
+// writer holds it exclusively. Both modes are reentrant like Mutex:
+// a reader can read again and the writer can read or write again.
+// GRWLock is not used because its reentrance is undefined, and MimeSystem
+// relies on it: write-locked mutators call read-locked node lookups.
+// Upgrading read lock to write lock is not supported, lockWrite() aborts
+// on it instead of deadlocking.
+// Waiting writers are preferred over new readers so that they don't starve.
+class RWLock : public RefCounted
+{
+public:
+    RWLock();
+    virtual ~RWLock();
+
+    void lockRead();
+    void unlockRead();
+    void lockWrite();
+    void unlockWrite();
+
+private:
+
+    GMutex m_lock;
+    GCond m_cond;
+    GThread* m_writer;
+    int m_writeDepth;
+    int m_waitingWriters;
+    std::map<GThread*,int> m_readDepth;
+};
+
 #endif /* MUTEX_H */
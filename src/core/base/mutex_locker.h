@@ -31,4 +31,30 @@ private:
     MutexLocker(const MutexLocker&);
     MutexLocker& operator=(const MutexLocker&);
 };
+
+class ReadLocker
+{
+public:
+    ReadLocker(RWLock* lock) : m_lock(lock) { m_lock->lockRead(); }
+    ~ReadLocker() { m_lock->unlockRead(); }
+
+private:
+    RWLock* m_lock;
+
+    ReadLocker(const ReadLocker&);
+    ReadLocker& operator=(const ReadLocker&);
+};
+
+class WriteLocker
+{
+public:
+    WriteLocker(RWLock* lock) : m_lock(lock) { m_lock->lockWrite(); }
+    ~WriteLocker() { m_lock->unlockWrite(); }
+
+private:
+    RWLock* m_lock;
+
+    WriteLocker(const WriteLocker&);
+    WriteLocker& operator=(const WriteLocker&);
+};
 #endif /* MUTEXLOCKER_H */
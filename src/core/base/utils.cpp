@@ -89,6 +89,38 @@ bool writeFile(const std::string &path, const std::string& buffer)
     return true;
 }
 
+bool writeFileAtomically(const std::string &path, const std::string& buffer)
+{
+    std::string tmp_path = path + ".tmp";
+    int fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+        return false;
+
+    const char* data = buffer.data();
+    size_t remaining = buffer.size();
+    bool written = true;
+    while (remaining > 0) {
+        ssize_t result = write(fd, data, remaining);
+        if (result < 0) {
+            if (errno == EINTR) continue;
+            written = false;
+            break;
+        }
+        data += result;
+        remaining -= result;
+    }
+
+    if (fsync(fd) != 0)
+        written = false;
+    close(fd);
+
+    if (!written || rename(tmp_path.c_str(), path.c_str()) != 0) {
+        unlink(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
 int rmdirHelper(const char *path, const struct stat *pStat, int flag, struct FTW *ftw)
 {
     switch(flag)
@@ -386,6 +418,23 @@ double get_current_time()
     return (double)current_time.tv_sec * NANO_SECOND + (double)current_time.tv_nsec;
 }
 
+bool read_mem_available(const std::string& meminfo_path, uint64_t& r_kb)
+{
+    std::ifstream meminfo(meminfo_path.c_str());
+    if (!meminfo.is_open())
+        return false;
+
+    std::string line;
+    while (std::getline(meminfo, line)) {
+        unsigned long long kb = 0;
+        if (sscanf(line.c_str(), "MemAvailable: %llu kB", &kb) == 1) {
+            r_kb = kb;
+            return true;
+        }
+    }
+    return false;
+}
+
 bool convertToWindowTypeSAM(const std::string& lsm, std::string& sam)
 {
     // The following window types are found in appinfo.json in current application dirs.
@@ -18,6 +18,7 @@
 #define UTILS_H
 
 #include <glib.h>
+#include <stdint.h>
 #include <time.h>
 
 #include <fstream>
@@ -55,6 +56,8 @@ struct AppVersion{
 
 std::string read_file(const std::string& file_name);
 bool writeFile(const std::string& filePath, const std::string& buffer);
+// writes to a temporary file, syncs and renames it, so a crash never leaves a partial file
+bool writeFileAtomically(const std::string& filePath, const std::string& buffer);
 bool makeDir(const std::string &path, bool withParent = true);
 bool removeDir(const std::string &path);
 bool removeFile(const std::string &path);
@@ -103,6 +106,8 @@ timespec diff(timespec start, timespec end);
 void set_slash_to_base_path(std::string& path);
 bool concat_to_filename(const std::string originPath, std::string& returnPath, const std::string addingStr);
 double get_current_time();
+// MemAvailable of meminfo file (/proc/meminfo) in kB
+bool read_mem_available(const std::string& meminfo_path, uint64_t& r_kb);
 
 #if 0
 std::string base64_encode(unsigned char const* , unsigned int len);
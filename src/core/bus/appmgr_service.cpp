@@ -77,7 +77,10 @@ LSMethod* AppMgrService::get_methods(std::string category) const {
       { API_GET_APP_LIFE_EVENTS,    AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_GET_APP_LIFE_STATUS,    AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_GET_FOREGROUND_APPINFO, AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
+      { API_GET_LAUNCH_LATENCY_STATS, AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
+      { API_GET_MEMORY_RECLAIM_STATUS, AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_LOCK_APP,               AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
+      { API_RECLAIM_MEMORY,         AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_REGISTER_APP,           AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_REGISTER_NATIVE_APP,    AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_NOTIFY_ALERT_CLOSED,    AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
@@ -109,6 +112,7 @@ LSMethod* AppMgrService::get_methods(std::string category) const {
       { API_LIST_ALL_HANDLERS_FOR_URL_PATTERN,  AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_LIST_ALL_HANDLERS_FOR_MULTIPLE_MIME,AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
       { API_LIST_ALL_HANDLERS_FOR_MULTIPLE_URL_PATTERN,AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
+      { API_GET_MIME_RESOLVE_CACHE_STATS,       AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
 
       // core: launchpoint
       { API_ADD_LAUNCHPOINT,        AppMgrService::OnApiCalled, LUNA_METHOD_FLAGS_NONE },
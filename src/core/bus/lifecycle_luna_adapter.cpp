@@ -18,15 +18,17 @@
 
 #include <boost/bind.hpp>
 
+#include <algorithm>
+
 #include "core/base/logging.h"
 #include "core/bus/appmgr_service.h"
 #include "core/bus/lunaservice_api.h"
 #include "core/lifecycle/app_life_manager.h"
+#include "core/lifecycle/launch_latency_tracer.h"
+#include "core/lifecycle/memory_reclaimer.h"
 #include "core/package/application_manager.h"
 #include "core/package/mime_system.h"
 
-#define SUBSKEY_RUNNING              "running"
-#define SUBSKEY_DEV_RUNNING          "dev_running"
 #define SUBSKEY_FOREGROUND_INFO      "foregroundAppInfo"
 #define SUBSKEY_FOREGROUND_INFO_EX   "foregroundAppInfoEx"
 #define SUBSKEY_GET_APP_LIFE_EVENTS  "getAppLifeEvents"
@@ -85,9 +87,15 @@ void LifeCycleLunaAdapter::InitLunaApiHandler() {
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_GET_FOREGROUND_APPINFO,
       "applicationManager.getForegroundAppInfo",
       boost::bind(&LifeCycleLunaAdapter::GetForegroundAppInfo, this, _1));
+  AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_GET_LAUNCH_LATENCY_STATS, "",
+      boost::bind(&LifeCycleLunaAdapter::GetLaunchLatencyStats, this, _1));
+  AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_GET_MEMORY_RECLAIM_STATUS, "",
+      boost::bind(&LifeCycleLunaAdapter::GetMemoryReclaimStatus, this, _1));
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_LOCK_APP,
       "applicationManager.lockApp",
       boost::bind(&LifeCycleLunaAdapter::LockApp, this, _1));
+  AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_RECLAIM_MEMORY, "",
+      boost::bind(&LifeCycleLunaAdapter::ReclaimMemory, this, _1));
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_REGISTER_APP, "",
       boost::bind(&LifeCycleLunaAdapter::RegisterApp, this, _1));
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_REGISTER_NATIVE_APP, "",
@@ -126,7 +134,8 @@ void LifeCycleLunaAdapter::RequestController(LunaTaskPtr task) {
       return;
     }
   } else {
-    if (!AppMgrService::instance().IsServiceReady() || ApplicationManager::instance().appScanner().isRunning()) {
+    // rescans don't block requests, roster is switched only when scanning is done
+    if (!AppMgrService::instance().IsServiceReady() || !ApplicationManager::instance().IsRosterReady()) {
       pending_tasks_on_scanner_.push_back(task);
       return;
     }
@@ -350,30 +359,31 @@ void LifeCycleLunaAdapter::CloseAllApps(LunaTaskPtr task) {
 }
 
 void LifeCycleLunaAdapter::Running(LunaTaskPtr task) {
-  pbnjson::JValue payload = pbnjson::Object();
-  pbnjson::JValue running_list = pbnjson::Array();
-  AppInfoManager::instance().get_running_list(running_list);
-
-  payload.put("returnValue", true);
-  payload.put("running", running_list);
-  if(LSMessageIsSubscription(task->lsmsg())) {
-      payload.put("subscribed",
-          LSSubscriptionAdd(task->lshandle(), SUBSKEY_RUNNING, task->lsmsg(), NULL));
-  }
-
-  task->ReplyResult(payload);
+  ReplyRunning(task, false);
 }
 
 void LifeCycleLunaAdapter::RunningForDev(LunaTaskPtr task) {
+  ReplyRunning(task, true);
+}
+
+// {"subscribe": boolean, "delta": boolean}
+// with "delta", subscriber gets the list and its revision first and then only changed apps
+void LifeCycleLunaAdapter::ReplyRunning(LunaTaskPtr task, bool devmode) {
   pbnjson::JValue payload = pbnjson::Object();
   pbnjson::JValue running_list = pbnjson::Array();
-  AppInfoManager::instance().get_running_list(running_list, true);
+  AppInfoManager::instance().get_running_list(running_list, devmode);
+  bool delta = task->jmsg()["delta"].asBool();
 
   payload.put("returnValue", true);
   payload.put("running", running_list);
+  if (delta)
+    payload.put("revision", (int64_t)AppInfoManager::instance().running_revision());
+
   if(LSMessageIsSubscription(task->lsmsg())) {
+      const char* subscription_key = delta ? (devmode ? SUBSKEY_DEV_RUNNING_DELTA : SUBSKEY_RUNNING_DELTA)
+                                           : (devmode ? SUBSKEY_DEV_RUNNING : SUBSKEY_RUNNING);
       payload.put("subscribed",
-          LSSubscriptionAdd(task->lshandle(), SUBSKEY_DEV_RUNNING, task->lsmsg(), NULL));
+          LSSubscriptionAdd(task->lshandle(), subscription_key, task->lsmsg(), NULL));
   }
 
   task->ReplyResult(payload);
@@ -442,6 +452,46 @@ void LifeCycleLunaAdapter::GetAppLifeStatus(LunaTaskPtr task) {
   task->ReplyResult(payload);
 }
 
+void LifeCycleLunaAdapter::GetLaunchLatencyStats(LunaTaskPtr task) {
+  const pbnjson::JValue& jmsg = task->jmsg();
+
+  // {"appId": string (optional), "reset": boolean (optional)}
+  std::string app_id = jmsg["appId"].isString() ? jmsg["appId"].asString() : "";
+  bool reset = jmsg["reset"].isBoolean() ? jmsg["reset"].asBool() : false;
+
+  // values are in milliseconds, percentiles are upper bounds of histogram buckets
+  pbnjson::JValue payload = LaunchLatencyTracer::instance().ToJson(app_id);
+  payload.put("returnValue", true);
+
+  if (reset) LaunchLatencyTracer::instance().Reset();
+
+  task->ReplyResult(payload);
+}
+
+void LifeCycleLunaAdapter::GetMemoryReclaimStatus(LunaTaskPtr task) {
+  pbnjson::JValue payload = MemoryReclaimer::instance().Status();
+  payload.put("returnValue", true);
+
+  task->ReplyResult(payload);
+}
+
+void LifeCycleLunaAdapter::ReclaimMemory(LunaTaskPtr task) {
+  const pbnjson::JValue& jmsg = task->jmsg();
+
+  // {"targetKB": integer (optional), "dryRun": boolean (optional)}
+  uint64_t target_kb = jmsg["targetKB"].isNumber() ? (uint64_t) std::max((int64_t) 0, jmsg["targetKB"].asNumber<int64_t>()) : 0;
+  bool dry_run = jmsg["dryRun"].isBoolean() ? jmsg["dryRun"].asBool() : false;
+
+  pbnjson::JValue payload = MemoryReclaimer::instance().Reclaim(target_kb, dry_run);
+  if (payload.hasKey("errorText")) {
+    task->ReplyResultWithError(API_ERR_CODE_GENERAL, payload["errorText"].asString());
+    return;
+  }
+  payload.put("returnValue", true);
+
+  task->ReplyResult(payload);
+}
+
 void LifeCycleLunaAdapter::GetForegroundAppInfo(LunaTaskPtr task) {
   const pbnjson::JValue& jmsg = task->jmsg();
 
@@ -48,11 +48,16 @@ class LifeCycleLunaAdapter {
   void GetAppLifeEvents(LunaTaskPtr task);
   void GetAppLifeStatus(LunaTaskPtr task);
   void GetForegroundAppInfo(LunaTaskPtr task);
+  void GetLaunchLatencyStats(LunaTaskPtr task);
+  void GetMemoryReclaimStatus(LunaTaskPtr task);
   void LockApp(LunaTaskPtr task);
+  void ReclaimMemory(LunaTaskPtr task);
   void RegisterApp(LunaTaskPtr task);
   void RegisterNativeApp(LunaTaskPtr task);
   void NotifyAlertClosed(LunaTaskPtr task);
 
+  void ReplyRunning(LunaTaskPtr task, bool devmode);
+
   void OnForegroundAppChanged(const std::string& app_id);
   void OnExtraForegroundInfoChanged(const pbnjson::JValue& foreground_info);
   void OnLifeCycleEventGenarated(const pbnjson::JValue& event);
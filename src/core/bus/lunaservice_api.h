@@ -34,7 +34,10 @@
 #define API_GET_APP_LIFE_EVENTS                 "getAppLifeEvents"
 #define API_GET_APP_LIFE_STATUS                 "getAppLifeStatus"
 #define API_GET_FOREGROUND_APPINFO              "getForegroundAppInfo"
+#define API_GET_LAUNCH_LATENCY_STATS            "getLaunchLatencyStats"
+#define API_GET_MEMORY_RECLAIM_STATUS           "getMemoryReclaimStatus"
 #define API_LOCK_APP                            "lockApp"
+#define API_RECLAIM_MEMORY                      "reclaimMemory"
 #define API_REGISTER_APP                        "registerApp"
 #define API_REGISTER_NATIVE_APP                 "registerNativeApp"
 #define API_NOTIFY_ALERT_CLOSED                 "notifyAlertClosed"
@@ -66,6 +69,7 @@
 #define API_LIST_ALL_HANDLERS_FOR_URL_PATTERN   "listAllHandlersForUrlPattern"
 #define API_LIST_ALL_HANDLERS_FOR_MULTIPLE_MIME "listAllHandlersForMultipleMime"
 #define API_LIST_ALL_HANDLERS_FOR_MULTIPLE_URL_PATTERN  "listAllHandlersForMultipleUrlPattern"
+#define API_GET_MIME_RESOLVE_CACHE_STATS        "getMimeResolveCacheStats"
 
 // core API: launchpoint
 #define API_ADD_LAUNCHPOINT                     "addLaunchPoint"
@@ -75,6 +79,14 @@
 #define API_LIST_LAUNCHPOINTS                   "listLaunchPoints"
 #define API_SEARCH_APPS                         "searchApps"  // this should move into package for later
 
+//---------------------------------------------------------------------------
+// [ Subscription key list ] (shared by luna adapters and managers replying them)
+//---------------------------------------------------------------------------
+#define SUBSKEY_RUNNING               "running"
+#define SUBSKEY_DEV_RUNNING           "dev_running"
+#define SUBSKEY_RUNNING_DELTA         "running_delta"
+#define SUBSKEY_DEV_RUNNING_DELTA     "dev_running_delta"
+
 //---------------------------------------------------------------------------
 // [ Error code list ]
 //---------------------------------------------------------------------------
@@ -120,6 +120,8 @@ void PackageLunaAdapter::PackageLunaAdapter::InitLunaApiHandler() {
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_LIST_ALL_HANDLERS_FOR_MULTIPLE_URL_PATTERN,
       "applicationManager.listAllHandlersForMultipleUrlPattern",
       boost::bind(&PackageLunaAdapter::RequestController, this, _1));
+  AppMgrService::instance().RegisterApiHandler(API_CATEGORY_GENERAL, API_GET_MIME_RESOLVE_CACHE_STATS, "",
+      boost::bind(&PackageLunaAdapter::RequestController, this, _1));
 
   // dev category
   AppMgrService::instance().RegisterApiHandler(API_CATEGORY_DEV, API_LIST_APPS, "applicationManager.listApps",
@@ -138,7 +140,8 @@ void PackageLunaAdapter::RequestController(LunaTaskPtr task) {
       return;
     }
   } else {
-    if (!AppMgrService::instance().IsServiceReady() || ApplicationManager::instance().appScanner().isRunning()) {
+    // rescans don't block requests, roster is switched only when scanning is done
+    if (!AppMgrService::instance().IsServiceReady() || !ApplicationManager::instance().IsRosterReady()) {
       LOG_INFO(MSGID_API_REQUEST, 4, PMLOGKS("category", task->category().c_str()),
                                      PMLOGKS("method", task->method().c_str()),
                                      PMLOGKS("status", "pending"),
@@ -193,6 +196,7 @@ void PackageLunaAdapter::HandleRequest(LunaTaskPtr task) {
     else if(API_LIST_ALL_HANDLERS_FOR_URL_PATTERN == task->method()) ListAllHandlersForUrlPattern(task);
     else if(API_LIST_ALL_HANDLERS_FOR_MULTIPLE_MIME == task->method()) ListAllHandlersForMultipleMime(task);
     else if(API_LIST_ALL_HANDLERS_FOR_MULTIPLE_URL_PATTERN == task->method()) ListAllHandlersForMultipleUrlPattern(task);
+    else if(API_GET_MIME_RESOLVE_CACHE_STATS == task->method()) GetMimeResolveCacheStats(task);
   } else if (API_CATEGORY_DEV == task->category()) {
     if(API_LIST_APPS == task->method()) ListAppsForDev(task);
   }
@@ -514,6 +518,15 @@ void PackageLunaAdapter::ListExtensionMap(LunaTaskPtr task) {
   task->ReplyResult(reply);
 }
 
+void PackageLunaAdapter::GetMimeResolveCacheStats(LunaTaskPtr task) {
+  // {}
+  pbnjson::JValue reply = pbnjson::Object();
+  reply.put("returnValue", true);
+  reply.put("cacheStats", MimeSystemImpl::instance().resolveCacheStatsAsJson());
+
+  task->ReplyResult(reply);
+}
+
 void PackageLunaAdapter::MimeTypeForExtension(LunaTaskPtr task) {
   const pbnjson::JValue& jmsg = task->jmsg();
 
@@ -63,6 +63,7 @@ class PackageLunaAdapter {
   void ListAllHandlersForUrlPattern(LunaTaskPtr task);
   void ListAllHandlersForMultipleMime(LunaTaskPtr task);
   void ListAllHandlersForMultipleUrlPattern(LunaTaskPtr task);
+  void GetMimeResolveCacheStats(LunaTaskPtr task);
 
   std::vector<LunaTaskPtr> pending_tasks_on_ready_;
   std::vector<LunaTaskPtr> pending_tasks_on_scanner_;
@@ -17,6 +17,7 @@
 #include "core/lifecycle/app_info.h"
 
 #include "core/base/logging.h"
+#include "core/base/utils.h"
 
 AppInfo::AppInfo(const std::string& app_id)
     : m_app_id(app_id)
@@ -24,6 +25,7 @@ AppInfo::AppInfo(const std::string& app_id)
     , m_removal_flag(false)
     , m_preload_mode_on(false)
     , m_last_launch_time(0)
+    , m_last_foreground_time(0)
     , m_life_status(LifeStatus::STOP)
     , m_runtime_status(RuntimeStatus::STOP)
     , m_virtual_launch_params(pbnjson::Object())
@@ -37,5 +39,7 @@ AppInfo::~AppInfo()
 void AppInfo::set_life_status(const LifeStatus& status)
 {
     LOG_DEBUG("[AppInfo] (%s) app_id: %s, status: %d", __FUNCTION__, m_app_id.c_str(), (int) status);
+    if (LifeStatus::FOREGROUND == status || LifeStatus::FOREGROUND == m_life_status)
+        m_last_foreground_time = get_current_time();
     m_life_status = status;
 }
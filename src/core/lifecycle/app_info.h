@@ -48,6 +48,7 @@ class AppInfo {
   bool is_remove_flagged() const { return m_removal_flag; }
   bool preload_mode_on() const { return m_preload_mode_on; }
   double last_launch_time() const { return m_last_launch_time; }
+  double last_foreground_time() const { return m_last_foreground_time; }
   LifeStatus life_status() const { return m_life_status; }
   RuntimeStatus runtime_status() const { return m_runtime_status; }
   const pbnjson::JValue& virtual_launch_params() const { return m_virtual_launch_params; }
@@ -68,6 +69,7 @@ class AppInfo {
   bool            m_removal_flag;
   bool            m_preload_mode_on;
   double          m_last_launch_time;
+  double          m_last_foreground_time; // last time when app entered or left foreground
   LifeStatus      m_life_status;
   RuntimeStatus   m_runtime_status;
   pbnjson::JValue m_virtual_launch_params;
@@ -24,7 +24,9 @@ const std::string& NULL_STR = "";
 const std::string& DEFAULT_NULL_APP = "@APP_INFO_DEFAULT_APP@";
 
 AppInfoManager::AppInfoManager()
-    : m_json_foreground_info(pbnjson::Array())
+    : m_running_seq(0),
+      m_running_revision(0),
+      m_json_foreground_info(pbnjson::Array())
 {
     m_default_app_info = std::make_shared<AppInfo>(DEFAULT_NULL_APP);
 }
@@ -241,6 +243,11 @@ double AppInfoManager::last_launch_time(const std::string& app_id)
     return get_app_info_for_getter(app_id)->last_launch_time();
 }
 
+double AppInfoManager::last_foreground_time(const std::string& app_id)
+{
+    return get_app_info_for_getter(app_id)->last_foreground_time();
+}
+
 LifeStatus AppInfoManager::life_status(const std::string& app_id)
 {
     return get_app_info_for_getter(app_id)->life_status();
@@ -339,14 +346,22 @@ void AppInfoManager::reset_all_update_info()
 ////////////////////////////////////////////////////////////////////
 void AppInfoManager::add_running_info(const std::string& app_id, const std::string& pid, const std::string& webprocid)
 {
-    for(auto& running_data: m_running_list)
+    auto seq_it = m_running_seq_by_app_id.find(app_id);
+    if(seq_it != m_running_seq_by_app_id.end())
     {
-        if(running_data->app_id == app_id)
-        {
-            running_data->pid = pid;
-            running_data->webprocid = webprocid;
+        RunningInfoPtr running_data = m_running_list[seq_it->second];
+        if(running_data->pid == pid && running_data->webprocid == webprocid)
             return;
+
+        if(running_data->pid != pid)
+        {
+            index_running_pid(running_data->pid, seq_it->second, false);
+            index_running_pid(pid, seq_it->second, true);
         }
+        ++m_running_revision;
+        running_data->pid = pid;
+        running_data->webprocid = webprocid;
+        return;
     }
 
     RunningInfoPtr new_running_item = std::make_shared<RunningInfo>(app_id, pid, webprocid);
@@ -361,21 +376,34 @@ void AppInfoManager::add_running_info(const std::string& app_id, const std::stri
                                     PMLOGKS("webprocid", webprocid.c_str()),
                                     PMLOGKS("status", "added"), "");
 
-    m_running_list.push_back(new_running_item);
+    AppDescPtr app_desc = ApplicationManager::instance().getAppById(app_id);
+    new_running_item->dev_app = (app_desc != NULL && AppTypeByDir::Dev == app_desc->getTypeByDir());
+
+    uint64_t seq = ++m_running_seq;
+    m_running_list[seq] = new_running_item;
+    m_running_seq_by_app_id[app_id] = seq;
+    index_running_pid(pid, seq, true);
+    ++m_running_revision;
 }
 
 void AppInfoManager::remove_running_info(const std::string& app_id)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&app_id](RunningInfoPtr running_data){ return (running_data->app_id == app_id); });
-    if(it == m_running_list.end())
+    auto it = m_running_seq_by_app_id.find(app_id);
+    if(it == m_running_seq_by_app_id.end())
     {
         LOG_ERROR(MSGID_RUNNING_LIST_ERR, 2, PMLOGKS("status", "failed_to_remove"),
                                              PMLOGKS("app_id", app_id.c_str()), "not found app_id in running_list");
         return;
     }
 
-    m_running_list.erase(it);
+    auto running_it = m_running_list.find(it->second);
+    if(running_it != m_running_list.end())
+    {
+        index_running_pid(running_it->second->pid, it->second, false);
+        m_running_list.erase(running_it);
+    }
+    m_running_seq_by_app_id.erase(it);
+    ++m_running_revision;
 
     LOG_INFO(MSGID_RUNNING_LIST, 2, PMLOGKS("app_id", app_id.c_str()), PMLOGKS("action", "removed"), "");
 }
@@ -383,7 +411,7 @@ void AppInfoManager::remove_running_info(const std::string& app_id)
 void AppInfoManager::get_running_app_ids(std::vector<std::string>& running_app_ids)
 {
     for(auto& running_data: m_running_list)
-        running_app_ids.push_back(running_data->app_id);
+        running_app_ids.push_back(running_data.second->app_id);
 }
 
 void AppInfoManager::get_running_list(pbnjson::JValue& running_list, bool devmode_only)
@@ -391,70 +419,100 @@ void AppInfoManager::get_running_list(pbnjson::JValue& running_list, bool devmod
     if(!running_list.isArray())
         return;
 
-    for(auto& running_data: m_running_list)
+    for(auto& running_entry: m_running_list)
     {
         pbnjson::JValue running_info = pbnjson::Object();
-        AppDescPtr app_desc = ApplicationManager::instance().getAppById(running_data->app_id);
-        if(app_desc == NULL)
-            continue;
+        if(make_running_info(running_entry.second, running_info, devmode_only))
+            running_list.append(running_info);
+    }
+}
 
-        if(devmode_only && AppTypeByDir::Dev != app_desc->getTypeByDir())
-            continue;
+bool AppInfoManager::get_running_info(const std::string& app_id, pbnjson::JValue& running_info, bool devmode_only)
+{
+    RunningInfoPtr running_data = find_running_info(app_id);
+    if(running_data == NULL)
+        return false;
+    return make_running_info(running_data, running_info, devmode_only);
+}
 
-        std::string app_type = ApplicationDescription::appTypeToString(app_desc->type());
-        running_info.put("id", running_data->app_id);
-        running_info.put("processid", running_data->pid);
-        running_info.put("webprocessid", running_data->webprocid);
-        running_info.put("defaultWindowType", app_desc->defaultWindowType());
-        running_info.put("appType", app_type);
+bool AppInfoManager::make_running_info(const RunningInfoPtr& running_data, pbnjson::JValue& running_info, bool devmode_only)
+{
+    AppDescPtr app_desc = ApplicationManager::instance().getAppById(running_data->app_id);
+    if(app_desc == NULL)
+        return false;
 
-        running_list.append(running_info);
-    }
+    if(devmode_only && !running_data->dev_app)
+        return false;
+
+    std::string app_type = ApplicationDescription::appTypeToString(app_desc->type());
+    running_info.put("id", running_data->app_id);
+    running_info.put("processid", running_data->pid);
+    running_info.put("webprocessid", running_data->webprocid);
+    running_info.put("defaultWindowType", app_desc->defaultWindowType());
+    running_info.put("appType", app_type);
+    return true;
 }
 
 RunningInfoPtr AppInfoManager::get_running_data(const std::string& app_id)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&app_id](const RunningInfoPtr running_data){ return (running_data->app_id == app_id); });
-    if(it != m_running_list.end())
-        return (*it);
-    return NULL;
+    return find_running_info(app_id);
 }
 
 bool AppInfoManager::is_running(const std::string& app_id)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&app_id](const RunningInfoPtr running_data){ return (running_data->app_id == app_id); });
-    if(it == m_running_list.end())
-        return false;
-    return true;
+    return (m_running_seq_by_app_id.count(app_id) > 0);
 }
 
 const std::string& AppInfoManager::get_app_id_by_pid(const std::string& pid)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&pid](const RunningInfoPtr running_data){ return (running_data->pid == pid); });
-    if(it == m_running_list.end())
+    // the earliest started app, if several apps run in the process
+    auto it = m_running_seqs_by_pid.find(pid);
+    if(it == m_running_seqs_by_pid.end())
         return NULL_STR;
-    return (*it)->app_id;
+    return m_running_list[*(it->second.begin())]->app_id;
 }
 
 const std::string& AppInfoManager::pid(const std::string& app_id)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&app_id](const RunningInfoPtr running_data){ return (running_data->app_id == app_id); });
-    if(it == m_running_list.end())
+    RunningInfoPtr running_data = find_running_info(app_id);
+    if(running_data == NULL)
         return NULL_STR;
-    return (*it)->pid;
+    return running_data->pid;
 }
 
 const std::string& AppInfoManager::webprocid(const std::string& app_id)
 {
-    auto it = std::find_if(m_running_list.begin(), m_running_list.end(),
-                          [&app_id](const RunningInfoPtr running_data){ return (running_data->app_id == app_id); });
-    if(it == m_running_list.end())
+    RunningInfoPtr running_data = find_running_info(app_id);
+    if(running_data == NULL)
         return NULL_STR;
-    return (*it)->webprocid;
+    return running_data->webprocid;
+}
+
+RunningInfoPtr AppInfoManager::find_running_info(const std::string& app_id) const
+{
+    auto seq_it = m_running_seq_by_app_id.find(app_id);
+    if(seq_it == m_running_seq_by_app_id.end())
+        return NULL;
+    auto it = m_running_list.find(seq_it->second);
+    if(it == m_running_list.end())
+        return NULL;
+    return it->second;
+}
+
+void AppInfoManager::index_running_pid(const std::string& pid, uint64_t seq, bool add)
+{
+    if(add)
+    {
+        m_running_seqs_by_pid[pid].insert(seq);
+        return;
+    }
+
+    auto it = m_running_seqs_by_pid.find(pid);
+    if(it == m_running_seqs_by_pid.end())
+        return;
+    it->second.erase(seq);
+    if(it->second.empty())
+        m_running_seqs_by_pid.erase(it);
 }
 
 ////////////////////////////////////////////////////////////////////
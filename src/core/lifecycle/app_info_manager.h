@@ -17,7 +17,10 @@
 #ifndef APP_INFO_MANAGER_H_
 #define APP_INFO_MANAGER_H_
 
+#include <map>
 #include <pbnjson.hpp>
+#include <set>
+#include <unordered_map>
 
 #include "core/base/singleton.h"
 #include "core/lifecycle/app_info.h"
@@ -28,13 +31,15 @@ struct RunningInfo
     std::string app_id;
     std::string pid;
     std::string webprocid;
+    bool dev_app;  // kept, description can be gone before app stops running
     RunningInfo(const std::string& _app_id, const std::string& _pid, const std::string& _webprocid)
-        : app_id(_app_id), pid(_pid), webprocid(_webprocid)
+        : app_id(_app_id), pid(_pid), webprocid(_webprocid), dev_app(false)
     {}
 };
 
 typedef std::shared_ptr<RunningInfo> RunningInfoPtr;
-typedef std::list<RunningInfoPtr> RunningInfoList;
+// keyed by insertion sequence, so iteration keeps the order apps started running in
+typedef std::map<uint64_t, RunningInfoPtr> RunningInfoList;
 typedef std::map<std::string, pbnjson::JValue> UpdateInfoList;
 
 class AppInfoManager: public Singleton<AppInfoManager>
@@ -61,6 +66,7 @@ public:
     const std::string update_type(const std::string& app_id);
     const std::string update_version(const std::string& app_id);
     double last_launch_time(const std::string& app_id);
+    double last_foreground_time(const std::string& app_id);
     LifeStatus life_status(const std::string& app_id);
     RuntimeStatus runtime_status(const std::string& app_id);
     const pbnjson::JValue& virtual_launch_params(const std::string& app_id);
@@ -98,6 +104,9 @@ public:
     // running info
     const std::string& get_app_id_by_pid(const std::string& pid);
     void get_running_list(pbnjson::JValue& running_list, bool devmode_only = false);
+    bool get_running_info(const std::string& app_id, pbnjson::JValue& running_info, bool devmode_only = false);
+    // increased on every change of running list, reported with running list deltas
+    uint64_t running_revision() const { return m_running_revision; }
     void get_running_app_ids(std::vector<std::string>& running_app_ids);
     RunningInfoPtr get_running_data(const std::string& app_id);
     void add_running_info(const std::string& app_id, const std::string& pid, const std::string& webprocid);
@@ -115,7 +124,8 @@ public:
 
     void set_last_foreground_app_id(const std::string& app_id) { m_last_foreground_app_id = app_id; }
     void set_current_foreground_app_id(const std::string& app_id) { m_current_foreground_app_id = app_id; }
-    void set_foreground_info(const pbnjson::JValue& new_info) { m_json_foreground_info = new_info.duplicate(); }
+    // kept as given (not duplicated), the info must not be modified afterwards
+    void set_foreground_info(const pbnjson::JValue& new_info) { m_json_foreground_info = new_info; }
     void set_foreground_apps(const std::vector<std::string>& new_apps) { m_foreground_apps = new_apps; }
 
 private:
@@ -125,10 +135,17 @@ private:
     AppInfoPtr get_app_info(const std::string& app_id);
     AppInfoPtr get_app_info_for_setter(const std::string& app_id);
     AppInfoPtr get_app_info_for_getter(const std::string& app_id);
+    RunningInfoPtr find_running_info(const std::string& app_id) const;
+    void index_running_pid(const std::string& pid, uint64_t seq, bool add);
+    static bool make_running_info(const RunningInfoPtr& running_data, pbnjson::JValue& running_info, bool devmode_only);
 
     AppInfoPtr      m_default_app_info;
     AppInfoList     m_appinfo_list;
     RunningInfoList m_running_list;
+    uint64_t        m_running_seq;
+    uint64_t        m_running_revision;
+    std::unordered_map<std::string, uint64_t> m_running_seq_by_app_id;
+    std::unordered_map<std::string, std::set<uint64_t>> m_running_seqs_by_pid;  // several apps can share a process
     UpdateInfoList  m_update_info_list;
 
     std::string     m_last_foreground_app_id;
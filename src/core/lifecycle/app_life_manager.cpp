@@ -25,6 +25,11 @@
 #include "core/base/utils.h"
 #include "core/bus/appmgr_service.h"
 #include "core/bus/lunaservice_api.h"
+#include "core/lifecycle/launch_latency_tracer.h"
+#include "core/lifecycle/life_handler/native_app_cgroup.h"
+#include "core/lifecycle/life_handler/native_app_checkpointer.h"
+#include "core/lifecycle/life_handler/native_app_zygote.h"
+#include "core/lifecycle/memory_reclaimer.h"
 #include "core/module/subscriber_of_lsm.h"
 #include "core/package/application_manager.h"
 #include "core/setting/settings.h"
@@ -47,6 +52,20 @@ void AppLifeManager::init() {
   lifecycle_router_.Init();
   AppInfoManager::instance().Init();
 
+  if (SettingsImpl::instance().use_native_app_cgroup_) {
+    (void) NativeAppCgroup::instance().Init(SettingsImpl::instance().native_app_cgroup_root_);
+  }
+
+  // started before sam gets bigger with app list and luna handles
+  if (SettingsImpl::instance().use_launch_zygote_) {
+    std::vector<std::string> warm_paths = { SettingsImpl::instance().appshellRunnerPath,
+                                            SettingsImpl::instance().qmlRunnerPath,
+                                            SettingsImpl::instance().jailerPath };
+    (void) NativeAppZygote::instance().Start(warm_paths);
+  }
+
+  NativeAppCheckpointer::instance().Init();
+
   // receive signal on service disconnected
   web_lifecycle_handler_.signal_service_disconnected.connect(
     boost::bind(&AppLifeManager::stop_all_webapp_item, this) );
@@ -185,6 +204,7 @@ void AppLifeManager::set_memory_checker_handler(MemoryCheckerInterface& memory_c
   memory_checker_ = &memory_checker;
   memory_checker.signal_memory_checking_start.connect( boost::bind(&AppLifeManager::on_memory_checking_start, this, _1) );
   memory_checker.signal_memory_checking_done.connect( boost::bind(&AppLifeManager::on_memory_checking_done, this, _1) );
+  memory_checker.signal_memory_reclaim_required.connect( boost::bind(&MemoryReclaimer::RequestReclaim, &MemoryReclaimer::instance(), _1, _2) );
 }
 
 void AppLifeManager::set_lastapp_handler(LastAppHandlerInterface& lastapp_handler) {
@@ -216,6 +236,10 @@ void AppLifeManager::on_prelaunching_done(const std::string& uid) {
     return;
   }
 
+  item->mark_time("prelaunch_done");
+  // prelaunchers can redirect item to another app
+  launch_item_list_.rekey(uid);
+
   // just finish launch if error occurs
   if (item->err_text().empty() == false) {
     finish_launching(item);
@@ -259,6 +283,8 @@ void AppLifeManager::on_memory_checking_done(const std::string& uid) {
     return;
   }
 
+  item->mark_time("memory_check_done");
+
   // just finish launch if error occurs
   if (item->err_text().empty() == false) {
     finish_launching(item);
@@ -282,6 +308,7 @@ void AppLifeManager::on_launching_done(const std::string& uid) {
                                PMLOGKS("uid", uid.c_str()),
                                PMLOGKS("status", "launching_done"), "");
 
+  item->mark_time("launch_done");
   finish_launching(item);
 }
 
@@ -304,6 +331,7 @@ void AppLifeManager::run_with_prelauncher(AppLaunchingItemPtr item) {
   }
 
   item->set_stage(AppLaunchingStage::PRELAUNCH);
+  item->mark_time("prelaunch");
 
   prelauncher_->add_item(item);
 }
@@ -320,6 +348,7 @@ void AppLifeManager::run_with_memory_checker(AppLaunchingItemPtr item) {
     return;
   }
   item->set_stage(AppLaunchingStage::MEMORY_CHECK);
+  item->mark_time("memory_check");
   memory_checker_->add_item(item);
   memory_checker_->run();
 }
@@ -331,6 +360,7 @@ void AppLifeManager::run_with_launcher(AppLaunchingItemPtr item) {
                                           PMLOGKS("PerfGroup", item->app_id().c_str()), "");
 
   item->set_stage(AppLaunchingStage::LAUNCH);
+  item->mark_time("launch");
   launch_app(item);
 }
 
@@ -359,8 +389,16 @@ void AppLifeManager::finish_launching(AppLaunchingItemPtr item) {
                                PMLOGKS("status", "finish_launching"),
                                PMLOGKS("mode", (is_automatic_launch ? "automatic_launch":"normal")), "");
 
+  // only launches which went through all stages are comparable
+  if (AppLaunchingStage::LAUNCH == item->stage() && item->err_text().empty()) {
+    item->mark_time("finished");
+    LaunchLatencyTracer::instance().Record(*item);
+  }
+
   signal_launching_finished(item);
   reply_with_result(item->lsmsg(), item->pid(), item->err_text().empty(), item->err_code(), item->err_text());
+  for (auto lsmsg : item->coalesced_lsmsgs())
+    reply_with_result(lsmsg, item->pid(), item->err_text().empty(), item->err_code(), item->err_text());
   remove_last_launching_app(item->app_id());
 
   std::string app_uid = item->uid();
@@ -464,7 +502,7 @@ void AppLifeManager::stop_all_webapp_item() {
   LOG_INFO(MSGID_APPLAUNCH_ERR, 2, PMLOGKS("status", "remove_webapp_in_loading_list"),
                                    PMLOGKS("reason", "WAM_disconnected"), "");
 
-  std::vector<LoadingAppItem> loading_apps = m_loading_app_list;
+  std::vector<LoadingAppItem> loading_apps(m_loading_app_list.begin(), m_loading_app_list.end());
   for (const auto& app: loading_apps) {
     if (std::get<1>(app) == AppType::Web)
       on_runtime_status_changed(std::get<0>(app), "", RuntimeStatus::STOP);
@@ -476,30 +514,56 @@ void AppLifeManager::stop_all_webapp_item() {
 ///////////////////////////////////////////////////////////////////////
 void AppLifeManager::on_running_app_added(const std::string& app_id, const std::string& pid,
     const std::string& webprocid) {
+  bool was_running = AppInfoManager::instance().is_running(app_id);
+  uint64_t revision = AppInfoManager::instance().running_revision();
+
   AppInfoManager::instance().add_running_info(app_id, pid, webprocid);
-  on_running_list_changed(app_id);
+  RunningInfoPtr running_data = AppInfoManager::instance().get_running_data(app_id);
+  bool dev_app = (running_data != NULL && running_data->dev_app);
+  if (revision == AppInfoManager::instance().running_revision())
+    on_running_list_changed(app_id, "", dev_app);
+  else
+    on_running_list_changed(app_id, was_running ? "changed" : "added", dev_app);
 }
 
 void AppLifeManager::on_running_app_removed(const std::string& app_id) {
 
+  // description of dev app can be removed already (uninstalled before it stops),
+  // so the flag kept in running info tells dev subscribers about its removal
+  RunningInfoPtr running_data = AppInfoManager::instance().get_running_data(app_id);
+  bool dev_app = (running_data != NULL && running_data->dev_app);
+
+  uint64_t revision = AppInfoManager::instance().running_revision();
   AppInfoManager::instance().remove_running_info(app_id);
-  on_running_list_changed(app_id);
+  on_running_list_changed(app_id, (revision == AppInfoManager::instance().running_revision()) ? "" : "removed", dev_app);
 
   if (is_in_automatic_pending_list(app_id))
     handle_automatic_app(app_id);
 }
 
-void AppLifeManager::on_running_list_changed(const std::string& app_id) {
-  pbnjson::JValue running_list = pbnjson::Array();
-  AppInfoManager::instance().get_running_list(running_list);
-  reply_subscription_for_running(running_list);
+// change is one of "added", "changed", "removed" or empty if the running list has not changed
+void AppLifeManager::on_running_list_changed(const std::string& app_id, const std::string& change, bool dev_app) {
+  LSHandle* handle = AppMgrService::instance().ServiceHandle();
 
-  AppDescPtr app_desc = ApplicationManager::instance().getAppById(app_id);
-  if (app_desc != NULL && AppTypeByDir::Dev == app_desc->getTypeByDir()) {
-    running_list = pbnjson::Array();
+  // full list is built only if somebody is subscribed for it
+  if (LSSubscriptionGetHandleSubscribersCount(handle, SUBSKEY_RUNNING) > 0) {
+    pbnjson::JValue running_list = pbnjson::Array();
+    AppInfoManager::instance().get_running_list(running_list);
+    reply_subscription_for_running(running_list);
+  }
+
+  if (dev_app && LSSubscriptionGetHandleSubscribersCount(handle, SUBSKEY_DEV_RUNNING) > 0) {
+    pbnjson::JValue running_list = pbnjson::Array();
     AppInfoManager::instance().get_running_list(running_list, true);
     reply_subscription_for_running(running_list, true);
   }
+
+  if (change.empty())
+    return;
+
+  reply_subscription_for_running_delta(app_id, change);
+  if (dev_app)
+    reply_subscription_for_running_delta(app_id, change, true);
 }
 
 ///////////////////////////////////////////////////////////////////////
@@ -684,7 +748,7 @@ void AppLifeManager::GenerateLifeCycleEvent(const std::string& app_id, const std
 
 void AppLifeManager::reply_subscription_for_running(const pbnjson::JValue& running_list, bool devmode) {
   pbnjson::JValue payload = pbnjson::Object();
-  std::string subscription_key = devmode ? "dev_running" : "running";
+  std::string subscription_key = devmode ? SUBSKEY_DEV_RUNNING : SUBSKEY_RUNNING;
 
   payload.put("running", running_list);
   payload.put("returnValue", true);
@@ -703,6 +767,47 @@ void AppLifeManager::reply_subscription_for_running(const pbnjson::JValue& runni
   }
 }
 
+// subscribers of running list deltas got the list with its revision first,
+// then each change of an app comes with the revision after the change.
+// revision can skip numbers for apps which are not reported (e.g. non-dev apps in dev list)
+void AppLifeManager::reply_subscription_for_running_delta(const std::string& app_id, const std::string& change, bool devmode) {
+  std::string subscription_key = devmode ? SUBSKEY_DEV_RUNNING_DELTA : SUBSKEY_RUNNING_DELTA;
+  LSHandle* handle = AppMgrService::instance().ServiceHandle();
+  if (LSSubscriptionGetHandleSubscribersCount(handle, subscription_key.c_str()) == 0)
+    return;
+
+  pbnjson::JValue payload = pbnjson::Object();
+  pbnjson::JValue running_info = pbnjson::Object();
+
+  if (change == "removed") {
+    running_info.put("id", app_id);
+  } else if (!AppInfoManager::instance().get_running_info(app_id, running_info, devmode)) {
+    // not reportable as a delta (e.g. description is gone), let subscribers resync with full list
+    pbnjson::JValue running_list = pbnjson::Array();
+    AppInfoManager::instance().get_running_list(running_list, devmode);
+    payload.put("resync", true);
+    payload.put("running", running_list);
+  }
+
+  payload.put("returnValue", true);
+  payload.put("revision", (int64_t)AppInfoManager::instance().running_revision());
+  if (!payload.hasKey("resync")) {
+    payload.put("change", change);
+    payload.put("app", running_info);
+  }
+
+  LOG_INFO(MSGID_SUBSCRIPTION_REPLY, 2, PMLOGKS("skey", subscription_key.c_str()),
+                                        PMLOGJSON("payload", JUtil::jsonToString(payload).c_str()), "");
+
+  LSErrorSafe lserror;
+  if (!LSSubscriptionReply(handle, subscription_key.c_str(), JUtil::jsonToString(payload).c_str(), &lserror)) {
+    LOG_ERROR(MSGID_LSCALL_ERR, 3, PMLOGKS("type", "subscriptionreply"),
+                                   PMLOGJSON("payload", JUtil::jsonToString(payload).c_str()),
+                                   PMLOGKS("where", "reply_running_delta_in_app_life_manager"),
+                                   "err: %s", lserror.message);
+  }
+}
+
 ///////////////////////////////////////////////////////////////////////
 /// API: launch
 ///////////////////////////////////////////////////////////////////////
@@ -735,6 +840,9 @@ void AppLifeManager::launch(AppLaunchRequestType rtype, const std::string& app_i
 
   // set start time
   new_item->set_launch_start_time(get_current_time());
+  new_item->mark_time("requested");
+
+  if (coalesce_launch(new_item)) return;
 
   // put new request into launching queue
   launch_item_list_.push_back(new_item);
@@ -760,6 +868,28 @@ void AppLifeManager::launch(AppLaunchRequestType rtype, const std::string& app_i
   run_with_prelauncher(new_item);
 }
 
+bool AppLifeManager::coalesce_launch(AppLaunchingItemPtr new_item) {
+
+  // key repeat or several clients can ask same launch at once,
+  // then later ones share in-flight launching instead of going through all stages again.
+  // request coming after the window is handled as relaunch
+  unsigned int window_ms = SettingsImpl::instance().launch_coalesce_window_ms_;
+  if (window_ms == 0) return false;
+
+  for (auto& launching_item : launch_item_list_) {
+    if (launching_item->app_id() != new_item->app_id()) continue;
+    if (new_item->launch_start_time() - launching_item->launch_start_time() > window_ms * 1000000.0) continue;
+    if (!launching_item->is_same_request(*new_item)) continue;
+
+    launching_item->coalesce(new_item->lsmsg());
+    LOG_INFO(MSGID_APPLAUNCH, 3, PMLOGKS("app_id", new_item->app_id().c_str()),
+                                 PMLOGKS("status", "coalesced_launch_request"),
+                                 PMLOGKS("uid", launching_item->uid().c_str()), "");
+    return true;
+  }
+  return false;
+}
+
 void AppLifeManager::handle_bridged_launch_request(const pbnjson::JValue& params) {
   std::string item_uid;
   if (!params.hasKey(SYS_LAUNCHING_UID) || params[SYS_LAUNCHING_UID].asString(item_uid) != CONV_OK) {
@@ -919,7 +1049,7 @@ void AppLifeManager::close_all_loading_apps() {
   for (auto& app_id : automatic_pending_list)
     handle_automatic_app(app_id, false);
 
-  std::vector<LoadingAppItem> loading_apps = m_loading_app_list;
+  std::vector<LoadingAppItem> loading_apps(m_loading_app_list.begin(), m_loading_app_list.end());
   for (const auto& app: loading_apps) {
     std::string err_text = "";
     close_by_app_id(std::get<0>(app), SAM_INTERNAL_ID, "", err_text, false, true);
@@ -1065,6 +1195,20 @@ bool AppLifeManager::is_fullscreen_window_type(const pbnjson::JValue& foreground
     return false;
 }
 
+bool AppLifeManager::is_foreground_entry_changed(const pbnjson::JValue& prev_foreground_info, int index, int prev_size,
+                                                 const std::string& app_id, const pbnjson::JValue& entry)
+{
+    if (index >= prev_size)
+        return true;
+
+    pbnjson::JValue prev_entry = prev_foreground_info[index];
+    if (prev_entry["appId"].asString() != app_id ||
+        prev_entry["windowType"].asString() != entry["windowType"].asString())
+        return true;
+
+    return (prev_entry != entry);
+}
+
 /*
 {
     "foregroundAppInfo": [
@@ -1104,11 +1248,17 @@ void AppLifeManager::on_foreground_info_changed(const pbnjson::JValue& jmsg)
     std::string prev_foreground_app_id = AppInfoManager::instance().get_current_foreground_app_id();
     std::vector<std::string> prev_foreground_apps = AppInfoManager::instance().get_foreground_apps();
     std::vector<std::string> new_foreground_apps;
+    std::unordered_set<std::string> new_foreground_app_set;
     pbnjson::JValue prev_foreground_info = AppInfoManager::instance().get_json_foreground_info();
     std::string new_foreground_app_id = "";
     bool found_fullscreen_window = false;
 
+    // entries are shared with the message instead of duplicated, nobody modifies them.
+    // change of foreground info is detected while filtering: entries are compared
+    // with the previous ones at the same position, by app id and window type first
     pbnjson::JValue new_foreground_info = pbnjson::Array();
+    bool foreground_info_changed = false;
+    int prev_array_size = prev_foreground_info.isArray() ? prev_foreground_info.arraySize() : 0;
     int array_size = lsm_foreground_info.arraySize();
     for (int i = 0 ; i < array_size ; ++i)
     {
@@ -1130,8 +1280,13 @@ void AppLifeManager::on_foreground_info_changed(const pbnjson::JValue& jmsg)
         LOG_INFO_WITH_CLOCK(MSGID_GET_FOREGROUND_APPINFO, 2, PMLOGKS("PerfType", "AppLaunch"),
                                                              PMLOGKS("PerfGroup", app_id.c_str()), "");
 
-        new_foreground_info.append(lsm_foreground_info[i].duplicate());
+        pbnjson::JValue entry = lsm_foreground_info[i];
+        if (!foreground_info_changed)
+            foreground_info_changed = is_foreground_entry_changed(prev_foreground_info, new_foreground_info.arraySize(), prev_array_size, app_id, entry);
+
+        new_foreground_info.append(entry);
         new_foreground_apps.push_back(app_id);
+        new_foreground_app_set.insert(app_id);
 
         if (is_fullscreen_window_type(lsm_foreground_info[i])) {
             found_fullscreen_window = true;
@@ -1153,15 +1308,13 @@ void AppLifeManager::on_foreground_info_changed(const pbnjson::JValue& jmsg)
     LOG_INFO(MSGID_FOREGROUND_INFO, 2, PMLOGKS("current_foreground_app", new_foreground_app_id.c_str()),
                                        PMLOGKS("prev_foreground_app", prev_foreground_app_id.c_str()), "");
 
+    if (new_foreground_info.arraySize() != prev_array_size)
+        foreground_info_changed = true;
+
     // set background
     for(auto& prev_app_id: prev_foreground_apps)
     {
-        bool found = false;
-        for(auto& current_app_id: new_foreground_apps) {
-            if((prev_app_id) == (current_app_id)) { found = true; break; }
-        }
-
-        if(found == false) {
+        if(new_foreground_app_set.count(prev_app_id) == 0) {
           switch(AppInfoManager::instance().life_status(prev_app_id)) {
             case LifeStatus::FOREGROUND:
             case LifeStatus::PAUSING:
@@ -1204,7 +1357,7 @@ void AppLifeManager::on_foreground_info_changed(const pbnjson::JValue& jmsg)
     }
 
     // reply subscription foreground with extraInfo
-    if (prev_foreground_info != new_foreground_info) {
+    if (foreground_info_changed) {
       signal_foreground_extra_info_changed(new_foreground_info);
     }
 }
@@ -1334,10 +1487,8 @@ void AppLifeManager::clear_launching_and_loading_items_by_app_id(const std::stri
 
     while(true)
     {
-        auto it = std::find_if(launch_item_list_.begin(), launch_item_list_.end(),
-                  [&app_id](AppLaunchingItemPtr item) { return (item->app_id() == app_id); });
-
-        if(it == launch_item_list_.end())
+        AppLaunchingItemPtr item = launch_item_list_.find_by_app_id(app_id);
+        if(item == NULL)
             break;
 
         AppDescPtr app_desc = ApplicationManager::instance().getAppById(app_id);
@@ -1360,19 +1511,13 @@ void AppLifeManager::clear_launching_and_loading_items_by_app_id(const std::stri
         }
 
         std::string err_text = "stopped launching";
-        (*it)->set_err_code_text(APP_LAUNCH_ERR_GENERAL, err_text);
-        finish_launching(*it);
+        item->set_err_code_text(APP_LAUNCH_ERR_GENERAL, err_text);
+        finish_launching(item);
         found = true;
     }
 
-    for(auto& loading_app: m_loading_app_list)
-    {
-        if(std::get<0>(loading_app) == app_id)
-        {
-            found = true;
-            break;
-        }
-    }
+    if(m_loading_app_index.count(app_id) > 0)
+        found = true;
 
     if(found)
         SetAppLifeStatus(app_id, "", LifeStatus::STOP);
@@ -1415,30 +1560,17 @@ void AppLifeManager::get_launching_app_ids(std::vector<std::string>& app_ids)
 
 AppLaunchingItemPtr AppLifeManager::get_launching_item_by_uid(const std::string& uid)
 {
-    for(auto& launching_item: launch_item_list_)
-    {
-        if(launching_item->uid() == uid)
-            return launching_item;
-    }
-    return NULL;
+    return launch_item_list_.find_by_uid(uid);
 }
 
 AppLaunchingItemPtr AppLifeManager::get_launching_item_by_app_id(const std::string& app_id)
 {
-    for(auto& launching_item: launch_item_list_)
-    {
-        if(launching_item->app_id() == app_id)
-            return launching_item;
-    }
-    return NULL;
+    return launch_item_list_.find_by_app_id(app_id);
 }
 
 void AppLifeManager::remove_item(const std::string& uid)
 {
-    auto it = std::find_if(launch_item_list_.begin(), launch_item_list_.end(), [&uid](AppLaunchingItemPtr item){return (item->uid() == uid);});
-    if(it == launch_item_list_.end())
-        return;
-    launch_item_list_.erase(it);
+    launch_item_list_.remove_by_uid(uid);
 }
 
 void AppLifeManager::add_item_into_automatic_pending_list(AppLaunchingItemPtr item)
@@ -1451,11 +1583,8 @@ void AppLifeManager::add_item_into_automatic_pending_list(AppLaunchingItemPtr it
 
 void AppLifeManager::remove_item_from_automatic_pending_list(const std::string& app_id)
 {
-    auto it = std::find_if(m_automatic_pending_list.begin(), m_automatic_pending_list.end(),
-                           [&app_id](AppLaunchingItemPtr item){ return (item->app_id() == app_id); });
-    if(it != m_automatic_pending_list.end())
+    if(m_automatic_pending_list.remove_by_app_id(app_id))
     {
-        m_automatic_pending_list.erase(it);
         LOG_INFO(MSGID_LAUNCH_LASTAPP, 3, PMLOGKS("app_id", app_id.c_str()),
                                           PMLOGKS("mode", "pending_automatic_app"),
                                           PMLOGKS("status", "removed_from_list"), "");
@@ -1464,11 +1593,7 @@ void AppLifeManager::remove_item_from_automatic_pending_list(const std::string&
 
 bool AppLifeManager::is_in_automatic_pending_list(const std::string& app_id)
 {
-    auto it = std::find_if(m_automatic_pending_list.begin(), m_automatic_pending_list.end(),
-                           [&app_id](AppLaunchingItemPtr item){ return (item->app_id() == app_id); });
-
-    if(it != m_automatic_pending_list.end()) return true;
-    else return false;
+    return (m_automatic_pending_list.find_by_app_id(app_id) != NULL);
 }
 
 void AppLifeManager::get_automatic_pending_app_ids(std::vector<std::string>& app_ids)
@@ -1485,8 +1610,7 @@ void AppLifeManager::get_loading_app_ids(std::vector<std::string>& app_ids)
 
 void AppLifeManager::add_loading_app(const std::string& app_id, const AppType& type)
 {
-    for(auto& loading_app: m_loading_app_list)
-        if(std::get<0>(loading_app) == app_id) return;
+    if(m_loading_app_index.count(app_id) > 0) return;
     // exception
     if("com.webos.app.container" == app_id || "com.webos.app.inputcommon" == app_id)
     {
@@ -1495,7 +1619,7 @@ void AppLifeManager::add_loading_app(const std::string& app_id, const AppType& t
     }
 
     LoadingAppItem new_loading_app = std::make_tuple(app_id, type, static_cast<double>(get_current_time()));
-    m_loading_app_list.push_back(new_loading_app);
+    m_loading_app_index[app_id] = m_loading_app_list.insert(m_loading_app_list.end(), new_loading_app);
 
     LOG_INFO(MSGID_LOADING_LIST, 1, PMLOGKS("app_id", app_id.c_str()), "added");
 
@@ -1505,11 +1629,11 @@ void AppLifeManager::add_loading_app(const std::string& app_id, const AppType& t
 
 void AppLifeManager::remove_loading_app(const std::string& app_id)
 {
-    auto it = std::find_if(m_loading_app_list.begin(), m_loading_app_list.end(),
-                           [&app_id](const LoadingAppItem& loading_app){ return (std::get<0>(loading_app) == app_id); });
-    if(it == m_loading_app_list.end())
+    auto it = m_loading_app_index.find(app_id);
+    if(it == m_loading_app_index.end())
         return;
-    m_loading_app_list.erase(it);
+    m_loading_app_list.erase(it->second);
+    m_loading_app_index.erase(it);
     LOG_INFO(MSGID_LOADING_LIST, 1, PMLOGKS("app_id", app_id.c_str()), "removed");
 
     if (last_loading_app_timer_set_.second == app_id)
@@ -1518,9 +1642,7 @@ void AppLifeManager::remove_loading_app(const std::string& app_id)
 
 void AppLifeManager::set_last_loading_app(const std::string& app_id)
 {
-    auto it = std::find_if(m_loading_app_list.begin(), m_loading_app_list.end(),
-                           [&app_id](const LoadingAppItem& loading_app){ return (std::get<0>(loading_app) == app_id); });
-    if(it == m_loading_app_list.end())
+    if(m_loading_app_index.count(app_id) == 0)
         return;
 
     add_timer_for_last_loading_app(app_id);
@@ -1532,9 +1654,7 @@ void AppLifeManager::add_timer_for_last_loading_app(const std::string& app_id)
     if ((last_loading_app_timer_set_.first != 0) && (last_loading_app_timer_set_.second == app_id))
         return;
 
-    auto it = std::find_if(m_loading_app_list.begin(), m_loading_app_list.end(),
-                           [&app_id](const LoadingAppItem& loading_app){ return (std::get<0>(loading_app) == app_id); });
-    if(it == m_loading_app_list.end())
+    if(m_loading_app_index.count(app_id) == 0)
         return;
 
     AppDescPtr app_desc = ApplicationManager::instance().getAppById(app_id);
@@ -1607,11 +1727,8 @@ bool AppLifeManager::has_only_preloaded_items(const std::string& app_id)
             return false;
     }
 
-    for(auto& loading_item: m_loading_app_list)
-    {
-        if(std::get<0>(loading_item) == app_id)
-            return false;
-    }
+    if(m_loading_app_index.count(app_id) > 0)
+        return false;
 
     if(AppInfoManager::instance().is_running(app_id) &&
        !AppInfoManager::instance().preload_mode_on(app_id))
@@ -1636,14 +1753,9 @@ bool AppLifeManager::is_launching_item_expired(AppLaunchingItemPtr item)
 bool AppLifeManager::is_loading_app_expired(const std::string& app_id)
 {
     double loading_start_time = 0;
-    for(auto& loading_app: m_loading_app_list)
-    {
-        if(std::get<0>(loading_app) == app_id)
-        {
-          loading_start_time = std::get<2>(loading_app);
-          break;
-        }
-    }
+    auto it = m_loading_app_index.find(app_id);
+    if(it != m_loading_app_index.end())
+        loading_start_time = std::get<2>(*(it->second));
 
     if (loading_start_time == 0)
     {
@@ -17,8 +17,11 @@
 #ifndef APP_LIFE_MANAGER_H_
 #define APP_LIFE_MANAGER_H_
 
+#include <list>
 #include <luna-service2/lunaservice.h>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "core/base/singleton.h"
 #include "core/lifecycle/app_info_manager.h"
@@ -100,6 +103,8 @@ private:
     void remove_loading_app(const std::string& app_id);
     void stop_all_webapp_item();
     bool is_fullscreen_window_type(const pbnjson::JValue& foreground_info);
+    static bool is_foreground_entry_changed(const pbnjson::JValue& prev_foreground_info, int index, int prev_size,
+                                            const std::string& app_id, const pbnjson::JValue& entry);
     void clear_launching_and_loading_items_by_app_id(const std::string& app_id);
     bool has_only_preloaded_items(const std::string& app_id);
     void handle_automatic_app(const std::string& app_id, bool continue_to_launch = true);
@@ -121,12 +126,13 @@ private:
     void on_launching_done(const std::string& uid);
     void on_running_app_added(const std::string& app_id, const std::string& pid, const std::string& webprocid);
     void on_running_app_removed(const std::string& app_id);
-    void on_running_list_changed(const std::string& app_id);
+    void on_running_list_changed(const std::string& app_id, const std::string& change, bool dev_app);
     void on_memory_checking_start(const std::string& uid);
     void on_runtime_status_changed(const std::string& app_id, const std::string& uid, const RuntimeStatus& life_status);
     void SetAppLifeStatus(const std::string& app_id, const std::string& uid, LifeStatus new_status);
     void on_foreground_info_changed(const pbnjson::JValue& jmsg);
 
+    bool coalesce_launch(AppLaunchingItemPtr new_item);
     void run_with_prelauncher(AppLaunchingItemPtr item);
     void run_with_memory_checker(AppLaunchingItemPtr item);
     void run_with_launcher(AppLaunchingItemPtr item);
@@ -144,6 +150,7 @@ private:
     void reply_subscription_for_app_life_status(const std::string& app_id,
         const std::string& uid, const LifeStatus& life_status);
     void reply_subscription_for_running(const pbnjson::JValue& running_list, bool devmode = false);
+    void reply_subscription_for_running_delta(const std::string& app_id, const std::string& change, bool devmode = false);
     void GenerateLifeCycleEvent(const std::string& app_id, const std::string& uid, LifeEvent event);
 
     AppLifeHandlerInterface* GetLifeHandlerForApp(const std::string& app_id);
@@ -162,12 +169,13 @@ private:
 
   // member variables
   std::vector<LifeCycleTaskPtr>     lifecycle_tasks_;
-  AppLaunchingItemList              launch_item_list_;
+  IndexedAppLaunchingItemList       launch_item_list_;
   AppCloseItemList                  close_item_list_;
   std::vector<std::string>          m_fullscreen_window_types;
-  AppLaunchingItemList              m_automatic_pending_list;
+  IndexedAppLaunchingItemList       m_automatic_pending_list;
   std::map<std::string,std::string> close_reason_info_;
-  std::vector<LoadingAppItem>       m_loading_app_list;
+  std::list<LoadingAppItem>         m_loading_app_list;
+  std::unordered_map<std::string, std::list<LoadingAppItem>::iterator> m_loading_app_index;
   std::vector<std::string>          last_launching_apps_;
   std::pair<guint, std::string>     last_loading_app_timer_set_;
 };
@@ -0,0 +1,153 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/launch_latency_tracer.h"
+
+#include <algorithm>
+
+#include "core/base/logging.h"
+#include "core/base/utils.h"
+
+// upper bounds of histogram buckets in ms, last bucket holds everything above
+static const double BUCKET_BOUNDS_MS[] = {
+  1, 2, 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000, 30000, 60000
+};
+static const size_t BUCKET_NUM = sizeof(BUCKET_BOUNDS_MS) / sizeof(BUCKET_BOUNDS_MS[0]) + 1;
+
+static const double NANO_SECONDS_PER_MS = 1000000;
+static const char* TRANSITION_TOTAL = "total";
+static const char* TRANSITION_REGISTRATION = "spawned->registered";
+
+LaunchLatencyTracer::Histogram::Histogram()
+    : buckets_(BUCKET_NUM, 0),
+      count_(0),
+      sum_(0),
+      min_(0),
+      max_(0) {
+}
+
+void LaunchLatencyTracer::Histogram::Add(double ms) {
+  size_t idx = 0;
+  while (idx < BUCKET_NUM - 1 && ms > BUCKET_BOUNDS_MS[idx]) ++idx;
+  ++buckets_[idx];
+
+  if (count_ == 0 || ms < min_) min_ = ms;
+  if (count_ == 0 || ms > max_) max_ = ms;
+  sum_ += ms;
+  ++count_;
+}
+
+// upper bound of the bucket holding the given ratio of samples, clamped to observed max
+double LaunchLatencyTracer::Histogram::Percentile(double ratio) const {
+  if (count_ == 0) return 0;
+
+  double target = ratio * count_;
+  unsigned int cumulative = 0;
+  for (size_t idx = 0; idx < BUCKET_NUM - 1; ++idx) {
+    cumulative += buckets_[idx];
+    if (cumulative >= target)
+      return std::min(BUCKET_BOUNDS_MS[idx], max_);
+  }
+  return max_;
+}
+
+pbnjson::JValue LaunchLatencyTracer::Histogram::ToJson() const {
+  pbnjson::JValue json = pbnjson::Object();
+  json.put("count", (int64_t) count_);
+  json.put("min", min_);
+  json.put("max", max_);
+  json.put("avg", count_ ? sum_ / count_ : 0.0);
+  json.put("p50", Percentile(0.5));
+  json.put("p90", Percentile(0.9));
+  json.put("p99", Percentile(0.99));
+  return json;
+}
+
+LaunchLatencyTracer::LaunchLatencyTracer() {
+}
+
+LaunchLatencyTracer::~LaunchLatencyTracer() {
+}
+
+void LaunchLatencyTracer::Record(const AppLaunchingItem& item) {
+
+  const LaunchTimeMarks& marks = item.time_marks();
+  if (marks.size() < 2) return;
+
+  for (size_t idx = 1; idx < marks.size(); ++idx) {
+    Add(item.app_id(), marks[idx-1].first + "->" + marks[idx].first,
+        (marks[idx].second - marks[idx-1].second) / NANO_SECONDS_PER_MS);
+  }
+
+  double total_ms = (marks.back().second - marks.front().second) / NANO_SECONDS_PER_MS;
+  Add(item.app_id(), TRANSITION_TOTAL, total_ms);
+
+  LOG_DEBUG("[LaunchLatency] app_id: %s, uid: %s, marks: %d, total: %f ms",
+            item.app_id().c_str(), item.uid().c_str(), (int) marks.size(), total_ms);
+}
+
+void LaunchLatencyTracer::MarkRegistrationPending(const std::string& app_id, double spawn_time) {
+  registration_pending_[app_id] = spawn_time;
+}
+
+void LaunchLatencyTracer::RecordRegistration(const std::string& app_id) {
+
+  auto it = registration_pending_.find(app_id);
+  if (it == registration_pending_.end()) return;
+
+  Add(app_id, TRANSITION_REGISTRATION, (get_current_time() - it->second) / NANO_SECONDS_PER_MS);
+  registration_pending_.erase(it);
+}
+
+pbnjson::JValue LaunchLatencyTracer::ToJson(const std::string& app_id) const {
+
+  pbnjson::JValue json = pbnjson::Object();
+  pbnjson::JValue apps = pbnjson::Object();
+
+  if (app_id.empty()) {
+    json.put("global", HistogramsToJson(global_));
+    for (const auto& it : per_app_) {
+      apps.put(it.first, HistogramsToJson(it.second));
+    }
+  } else {
+    auto it = per_app_.find(app_id);
+    apps.put(app_id, (it != per_app_.end()) ? HistogramsToJson(it->second) : pbnjson::Object());
+  }
+
+  json.put("apps", apps);
+  return json;
+}
+
+void LaunchLatencyTracer::Reset() {
+  global_.clear();
+  per_app_.clear();
+}
+
+void LaunchLatencyTracer::Add(const std::string& app_id, const std::string& transition, double ms) {
+  // clock failure gives negative value
+  if (ms < 0) return;
+
+  global_[transition].Add(ms);
+  per_app_[app_id][transition].Add(ms);
+}
+
+pbnjson::JValue LaunchLatencyTracer::HistogramsToJson(const HistogramMap& histograms) {
+  pbnjson::JValue json = pbnjson::Object();
+  for (const auto& it : histograms) {
+    json.put(it.first, it.second.ToJson());
+  }
+  return json;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_LAUNCH_LATENCY_TRACER_H_
+#define CORE_LIFECYCLE_LAUNCH_LATENCY_TRACER_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <pbnjson.hpp>
+
+#include "core/base/singleton.h"
+#include "core/lifecycle/launching_item.h"
+
+// Aggregates time marks of finished launching items into latency histograms.
+// Each transition between two consecutive marks ("prelaunch->prelaunch_done")
+// gets its own histogram, globally and per app, together with "total".
+class LaunchLatencyTracer : public Singleton<LaunchLatencyTracer> {
+ public:
+  LaunchLatencyTracer();
+  ~LaunchLatencyTracer();
+
+  void Record(const AppLaunchingItem& item);
+
+  // native apps register to SAM after launching item is finished,
+  // so registration latency is measured from process spawn separately
+  void MarkRegistrationPending(const std::string& app_id, double spawn_time);
+  void RecordRegistration(const std::string& app_id);
+
+  // empty app_id returns every app
+  pbnjson::JValue ToJson(const std::string& app_id) const;
+  void Reset();
+
+ private:
+  class Histogram {
+   public:
+    Histogram();
+    void Add(double ms);
+    double Percentile(double ratio) const;
+    pbnjson::JValue ToJson() const;
+
+   private:
+    std::vector<unsigned int> buckets_;
+    unsigned int count_;
+    double sum_;
+    double min_;
+    double max_;
+  };
+
+  typedef std::map<std::string, Histogram> HistogramMap;
+
+  void Add(const std::string& app_id, const std::string& transition, double ms);
+  static pbnjson::JValue HistogramsToJson(const HistogramMap& histograms);
+
+  HistogramMap global_;
+  std::map<std::string, HistogramMap> per_app_;
+  std::map<std::string, double> registration_pending_;
+};
+
+#endif // CORE_LIFECYCLE_LAUNCH_LATENCY_TRACER_H_
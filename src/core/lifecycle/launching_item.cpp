@@ -22,6 +22,7 @@
 #include <boost/uuid/uuid_generators.hpp>
 
 #include "core/base/logging.h"
+#include "core/base/utils.h"
 #include "core/package/application_manager.h"
 
 AppLaunchingItem::AppLaunchingItem(const std::string& app_id, AppLaunchRequestType rtype, const pbnjson::JValue& params, LSMessage* lsmsg)
@@ -61,6 +62,9 @@ AppLaunchingItem::~AppLaunchingItem()
 
     if(m_lsmsg != NULL)
         LSMessageUnref(m_lsmsg);
+
+    for(auto lsmsg: m_coalesced_lsmsgs)
+        LSMessageUnref(lsmsg);
 }
 
 bool AppLaunchingItem::set_redirection(const std::string& target_app_id, const pbnjson::JValue& new_params)
@@ -86,3 +90,147 @@ bool AppLaunchingItem::set_redirection(const std::string& target_app_id, const p
 
     return true;
 }
+
+void AppLaunchingItem::set_sub_stage(const int stage)
+{
+    m_sub_stage = stage;
+    mark_time("sub_stage_" + boost::lexical_cast<std::string>(stage));
+}
+
+void AppLaunchingItem::mark_time(const std::string& point)
+{
+    m_time_marks.push_back(std::make_pair(point, get_current_time()));
+}
+
+bool AppLaunchingItem::is_same_request(const AppLaunchingItem& other) const
+{
+    // redirected item has params of target app, which can't be compared
+    if(m_redirected || other.m_redirected)
+        return false;
+
+    if(m_automatic_launch || other.m_automatic_launch)
+        return false;
+
+    return m_app_id == other.m_app_id &&
+           m_rtype == other.m_rtype &&
+           m_preload == other.m_preload &&
+           m_keep_alive == other.m_keep_alive &&
+           m_launch_reason == other.m_launch_reason &&
+           m_params == other.m_params;
+}
+
+void AppLaunchingItem::coalesce(LSMessage* lsmsg)
+{
+    if(lsmsg == NULL)
+        return;
+
+    LSMessageRef(lsmsg);
+    m_coalesced_lsmsgs.push_back(lsmsg);
+}
+
+void IndexedAppLaunchingItemList::push_back(AppLaunchingItemPtr item)
+{
+    iterator it = m_items.insert(m_items.end(), item);
+    m_by_uid[item->uid()] = IndexEntry{it, item->app_id()};
+    m_by_app_id[item->app_id()].push_back(it);
+}
+
+IndexedAppLaunchingItemList::iterator IndexedAppLaunchingItemList::erase(iterator it)
+{
+    auto uid_it = m_by_uid.find((*it)->uid());
+    if(uid_it != m_by_uid.end() && uid_it->second.item_it == it)
+    {
+        unindex_app_id(uid_it->second.app_id, it);
+        m_by_uid.erase(uid_it);
+    }
+
+    return m_items.erase(it);
+}
+
+bool IndexedAppLaunchingItemList::remove_by_uid(const std::string& uid)
+{
+    auto uid_it = m_by_uid.find(uid);
+    if(uid_it == m_by_uid.end())
+        return false;
+    erase(uid_it->second.item_it);
+    return true;
+}
+
+bool IndexedAppLaunchingItemList::remove_by_app_id(const std::string& app_id)
+{
+    auto app_it = m_by_app_id.find(app_id);
+    if(app_it == m_by_app_id.end())
+        return false;
+
+    for(iterator it : app_it->second)
+    {
+        if((*it)->app_id() == app_id)
+        {
+            erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void IndexedAppLaunchingItemList::rekey(const std::string& uid)
+{
+    auto uid_it = m_by_uid.find(uid);
+    if(uid_it == m_by_uid.end())
+        return;
+
+    IndexEntry& entry = uid_it->second;
+    const std::string& app_id = (*entry.item_it)->app_id();
+    if(entry.app_id == app_id)
+        return;
+
+    unindex_app_id(entry.app_id, entry.item_it);
+    entry.app_id = app_id;
+    index_app_id(app_id, entry.item_it);
+}
+
+AppLaunchingItemPtr IndexedAppLaunchingItemList::find_by_uid(const std::string& uid) const
+{
+    auto uid_it = m_by_uid.find(uid);
+    if(uid_it == m_by_uid.end())
+        return NULL;
+    return *(uid_it->second.item_it);
+}
+
+AppLaunchingItemPtr IndexedAppLaunchingItemList::find_by_app_id(const std::string& app_id) const
+{
+    auto app_it = m_by_app_id.find(app_id);
+    if(app_it == m_by_app_id.end())
+        return NULL;
+
+    for(iterator it : app_it->second)
+    {
+        if((*it)->app_id() == app_id)
+            return *it;
+    }
+    return NULL;
+}
+
+void IndexedAppLaunchingItemList::index_app_id(const std::string& app_id, iterator it)
+{
+    // keep bucket in insertion order, so the earliest item is found first
+    std::list<iterator>& bucket = m_by_app_id[app_id];
+    auto pos = bucket.begin();
+    for(iterator item_it = m_items.begin(); item_it != it && pos != bucket.end(); ++item_it)
+    {
+        if(*pos == item_it)
+            ++pos;
+    }
+    bucket.insert(pos, it);
+}
+
+void IndexedAppLaunchingItemList::unindex_app_id(const std::string& app_id, iterator it)
+{
+    auto app_it = m_by_app_id.find(app_id);
+    if(app_it == m_by_app_id.end())
+        return;
+
+    app_it->second.remove(it);
+    if(app_it->second.empty())
+        m_by_app_id.erase(app_it);
+}
@@ -20,6 +20,9 @@
 #include <luna-service2/lunaservice.h>
 #include <list>
 #include <pbnjson.hpp>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "core/lifecycle/application_errors.h"
 #include "core/package/application_description.h"
@@ -42,6 +45,9 @@ enum class AppLaunchingStage
     DONE,
 };
 
+// <point name, monotonic time in ns>
+typedef std::vector<std::pair<std::string, double> > LaunchTimeMarks;
+
 class AppLaunchingItem
 {
 public:
@@ -64,6 +70,7 @@ public:
     bool automatic_launch() const { return m_automatic_launch; }
     const pbnjson::JValue& params() const { return m_params; }
     LSMessage* lsmsg() const { return m_lsmsg; }
+    const std::vector<LSMessage*>& coalesced_lsmsgs() const { return m_coalesced_lsmsgs; }
     LSMessageToken return_token() const { return m_return_token; }
     const pbnjson::JValue& return_jmsg() const { return m_return_jmsg; }
     int err_code() const { return m_err_code; }
@@ -71,11 +78,12 @@ public:
     const double& launch_start_time() const { return m_launch_start_time; }
     const std::string& launch_reason() const { return m_launch_reason; }
     bool is_last_input_app() const { return m_last_input_app; }
+    const LaunchTimeMarks& time_marks() const { return m_time_marks; }
 
     // re-code redirection for app_desc and consider other values again
     bool set_redirection(const std::string& target_app_id, const pbnjson::JValue& new_params);
     void set_stage(AppLaunchingStage stage) { m_stage = stage; }
-    void set_sub_stage(const int stage) { m_sub_stage = stage; }
+    void set_sub_stage(const int stage);
     void set_pid(const std::string& pid) { m_pid = pid; }
     void set_caller_id(const std::string& id) { m_caller_id = id; }
     void set_caller_pid(const std::string& pid) { m_caller_pid = pid; }
@@ -93,6 +101,11 @@ public:
     void set_launch_start_time(const double& start_time) { m_launch_start_time = start_time; }
     void set_launch_reason(const std::string& launch_reason) { m_launch_reason = launch_reason; }
     void set_last_input_app(bool v) { m_last_input_app = v; }
+    // record when launching passes the given point, used for latency tracing
+    void mark_time(const std::string& point);
+    // identical request can share this launching and its result
+    bool is_same_request(const AppLaunchingItem& other) const;
+    void coalesce(LSMessage* lsmsg);
 
 private:
     std::string             m_uid;
@@ -105,6 +118,7 @@ private:
     int                     m_sub_stage;
     pbnjson::JValue         m_params;
     LSMessage*              m_lsmsg;
+    std::vector<LSMessage*> m_coalesced_lsmsgs;
     std::string             m_caller_id;
     std::string             m_caller_pid;
     bool                    m_show_splash;
@@ -119,9 +133,51 @@ private:
     double                  m_launch_start_time;
     std::string             m_launch_reason;
     bool                    m_last_input_app;
+    LaunchTimeMarks         m_time_marks;
 };
 
 typedef std::shared_ptr<AppLaunchingItem> AppLaunchingItemPtr;
 typedef std::list<AppLaunchingItemPtr> AppLaunchingItemList;
 
+// launching items in insertion order, indexed by uid and app id.
+// item is kept under the app id it was indexed with, so redirecting a listed item
+// never leaves a stale index. lookups skip redirected items until rekey() is called for them
+class IndexedAppLaunchingItemList
+{
+public:
+    typedef AppLaunchingItemList::iterator iterator;
+    typedef AppLaunchingItemList::const_iterator const_iterator;
+
+    iterator begin() { return m_items.begin(); }
+    iterator end() { return m_items.end(); }
+    const_iterator begin() const { return m_items.begin(); }
+    const_iterator end() const { return m_items.end(); }
+    bool empty() const { return m_items.empty(); }
+    size_t size() const { return m_items.size(); }
+
+    void push_back(AppLaunchingItemPtr item);
+    iterator erase(iterator it);
+    bool remove_by_uid(const std::string& uid);
+    bool remove_by_app_id(const std::string& app_id);
+    // move item to the bucket of its current app id, called once it's redirected
+    void rekey(const std::string& uid);
+
+    AppLaunchingItemPtr find_by_uid(const std::string& uid) const;
+    // the earliest added one, if there are several items for the app
+    AppLaunchingItemPtr find_by_app_id(const std::string& app_id) const;
+
+private:
+    struct IndexEntry {
+        iterator    item_it;
+        std::string app_id;  // key in m_by_app_id
+    };
+
+    void index_app_id(const std::string& app_id, iterator it);
+    void unindex_app_id(const std::string& app_id, iterator it);
+
+    AppLaunchingItemList m_items;
+    std::unordered_map<std::string, IndexEntry> m_by_uid;
+    std::unordered_map<std::string, std::list<iterator>> m_by_app_id;
+};
+
 #endif
@@ -0,0 +1,196 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/life_handler/native_app_cgroup.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+
+#include "core/base/logging.h"
+
+static const char* CGROUP_PROCS_FILE = "/cgroup.procs";
+static const char* CGROUP_KILL_FILE = "/cgroup.kill";
+static const char* CGROUP_CONTROLLERS_FILE = "/cgroup.controllers";
+
+static std::string GroupDirOf(const std::string& procs_path) {
+  return procs_path.substr(0, procs_path.rfind('/'));
+}
+
+NativeAppCgroup::NativeAppCgroup()
+    : enabled_(false),
+      has_kill_(false) {
+}
+
+NativeAppCgroup::~NativeAppCgroup() {
+}
+
+bool NativeAppCgroup::Init(const std::string& root) {
+
+  enabled_ = false;
+  root_ = root;
+  while (root_.size() > 1 && root_.back() == '/')
+    root_.erase(std::prev(root_.end()));
+
+  bool created = (mkdir(root_.c_str(), 0755) == 0);
+  if (!created && errno != EEXIST) {
+    LOG_WARNING(MSGID_NATIVE_APP_CGROUP, 2, PMLOGKS("status", "fail_to_make_root"),
+                                            PMLOGKS("root", root_.c_str()), "errno: %d", errno);
+    return false;
+  }
+
+  // every directory of cgroup v2 hierarchy has cgroup.controllers
+  if (access((root_ + CGROUP_CONTROLLERS_FILE).c_str(), F_OK) != 0) {
+    LOG_WARNING(MSGID_NATIVE_APP_CGROUP, 2, PMLOGKS("status", "not_cgroup2"),
+                                            PMLOGKS("root", root_.c_str()), "fall back to process table");
+    if (created) (void) rmdir(root_.c_str());
+    return false;
+  }
+
+  // cgroup.kill is supported since linux 5.14
+  has_kill_ = (access((root_ + CGROUP_KILL_FILE).c_str(), F_OK) == 0);
+  enabled_ = true;
+
+  // groups from previous sam process, apps in them are not managed anymore
+  DIR* dir = opendir(root_.c_str());
+  if (dir) {
+    struct dirent* entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+      if (entry->d_type != DT_DIR || entry->d_name[0] == '.') continue;
+      stale_groups_.insert(root_ + "/" + entry->d_name);
+    }
+    closedir(dir);
+  }
+  RemoveStaleGroups();
+
+  LOG_INFO(MSGID_NATIVE_APP_CGROUP, 3, PMLOGKS("status", "enabled"),
+                                       PMLOGKS("root", root_.c_str()),
+                                       PMLOGKFV("has_kill", "%d", (int) has_kill_), "");
+  return true;
+}
+
+std::string NativeAppCgroup::Prepare(const std::string& uid) {
+
+  if (!enabled_ || uid.empty()) return "";
+
+  RemoveStaleGroups();
+
+  std::string group = root_ + "/" + uid;
+  if (mkdir(group.c_str(), 0755) != 0 && errno != EEXIST) {
+    LOG_WARNING(MSGID_NATIVE_APP_CGROUP, 2, PMLOGKS("status", "fail_to_make_group"),
+                                            PMLOGKS("group", group.c_str()), "errno: %d", errno);
+    return "";
+  }
+  return group + CGROUP_PROCS_FILE;
+}
+
+void NativeAppCgroup::Discard(const std::string& procs_path) {
+
+  if (procs_path.empty()) return;
+  (void) rmdir(GroupDirOf(procs_path).c_str());
+}
+
+void NativeAppCgroup::EnterInChild(void* procs_path) {
+
+  // runs between fork and exec, so only async-signal-safe calls are allowed here
+  if (procs_path == NULL) return;
+  int fd = open(static_cast<const char*>(procs_path), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) return;
+  (void) write(fd, "0", 1);
+  close(fd);
+}
+
+bool NativeAppCgroup::Attach(pid_t pid, const std::string& procs_path) {
+
+  if (!enabled_ || procs_path.empty() || pid <= 0) return false;
+
+  // no-op for forked process already moved by EnterInChild
+  if (!WriteFile(procs_path, std::to_string(pid).c_str())) {
+    LOG_WARNING(MSGID_NATIVE_APP_CGROUP, 2, PMLOGKS("status", "fail_to_attach"),
+                                            PMLOGKS("procs", procs_path.c_str()), "pid: %d", (int) pid);
+    Discard(procs_path);
+    return false;
+  }
+
+  groups_[pid] = GroupDirOf(procs_path);
+  return true;
+}
+
+void NativeAppCgroup::Remove(pid_t pid) {
+
+  auto it = groups_.find(pid);
+  if (it == groups_.end()) return;
+
+  // children can outlive main process, then group is removed once they are gone
+  if (rmdir(it->second.c_str()) != 0 && errno != ENOENT) {
+    stale_groups_.insert(it->second);
+  }
+  groups_.erase(it);
+}
+
+bool NativeAppCgroup::GetPids(pid_t pid, std::vector<pid_t>& pids) const {
+
+  auto it = groups_.find(pid);
+  if (it == groups_.end()) return false;
+
+  std::ifstream procs((it->second + CGROUP_PROCS_FILE).c_str());
+  if (!procs.is_open()) return false;
+
+  pids.push_back(pid);
+  pid_t member = 0;
+  while (procs >> member) {
+    if (member != pid) pids.push_back(member);
+  }
+  return true;
+}
+
+bool NativeAppCgroup::Kill(pid_t pid) const {
+
+  if (!has_kill_) return false;
+
+  auto it = groups_.find(pid);
+  if (it == groups_.end()) return false;
+
+  return WriteFile(it->second + CGROUP_KILL_FILE, "1");
+}
+
+bool NativeAppCgroup::WriteFile(const std::string& path, const char* value) {
+
+  int fd = open(path.c_str(), O_WRONLY | O_CLOEXEC);
+  if (fd < 0) return false;
+
+  size_t len = strlen(value);
+  bool success = (write(fd, value, len) == (ssize_t) len);
+  close(fd);
+  return success;
+}
+
+void NativeAppCgroup::RemoveStaleGroups() {
+
+  auto it = stale_groups_.begin();
+  while (it != stale_groups_.end()) {
+    if (rmdir(it->c_str()) == 0 || errno == ENOENT) {
+      it = stale_groups_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
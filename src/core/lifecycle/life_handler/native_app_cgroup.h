@@ -0,0 +1,70 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CGROUP_H_
+#define CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CGROUP_H_
+
+#include <sys/types.h>
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "core/base/singleton.h"
+
+// Puts each native app process into its own cgroup (v2) under configured root,
+// so that all processes of an app are read from cgroup.procs and killed at once
+// with cgroup.kill instead of walking whole process table.
+// Every method reports failure when cgroup v2 is not available,
+// then caller should fall back to process table walk.
+class NativeAppCgroup : public Singleton<NativeAppCgroup> {
+ public:
+  NativeAppCgroup();
+  ~NativeAppCgroup();
+
+  // root is given separately so that it can point to a local hierarchy
+  bool Init(const std::string& root);
+  bool IsEnabled() const { return enabled_; }
+
+  // creates empty group for new launch and returns its cgroup.procs path,
+  // returns empty string if group cannot be used
+  std::string Prepare(const std::string& uid);
+  void Discard(const std::string& procs_path);
+  // g_spawn child_setup: moves forked process into group before exec
+  static void EnterInChild(void* procs_path);
+  // binds main pid to the group, pid is moved into group if it's not yet there
+  bool Attach(pid_t pid, const std::string& procs_path);
+  void Remove(pid_t pid);
+
+  // main pid comes first, like process table walk
+  bool GetPids(pid_t pid, std::vector<pid_t>& pids) const;
+  bool Kill(pid_t pid) const;
+
+ private:
+  friend class Singleton<NativeAppCgroup>;
+
+  static bool WriteFile(const std::string& path, const char* value);
+  void RemoveStaleGroups();
+
+  bool enabled_;
+  bool has_kill_;
+  std::string root_;
+  std::map<pid_t, std::string> groups_;  // main pid -> group directory
+  std::set<std::string> stale_groups_;   // groups left busy by orphaned children
+};
+
+#endif  // CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CGROUP_H_
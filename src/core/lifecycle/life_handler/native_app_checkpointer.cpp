@@ -0,0 +1,379 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/life_handler/native_app_checkpointer.h"
+
+#ifdef HAVE_LIBCRIU
+#include <criu/criu.h>
+#endif
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <boost/bind.hpp>
+
+#include "core/base/logging.h"
+#include "core/base/utils.h"
+#include "core/lifecycle/app_info_manager.h"
+#include "core/lifecycle/app_life_manager.h"
+#include "core/setting/settings.h"
+
+static const char* STAMP_FILE = "/sam-stamp";
+static const char* DUMPING_SUFFIX = ".dumping";
+#ifdef HAVE_LIBCRIU
+static const char* DUMP_LOG_FILE = "dump.log";
+static const char* RESTORE_LOG_FILE = "restore.log";
+#endif
+
+NativeAppCheckpointer::NativeAppCheckpointer()
+    : enabled_(false) {
+}
+
+NativeAppCheckpointer::~NativeAppCheckpointer() {
+  while (!pending_.empty()) {
+    CancelPending(pending_.begin()->first);
+  }
+
+  // running dumps are waited, their results are dropped with idle callbacks
+  for (const auto& it : dumping_) {
+    DumpJob* job = it.second;
+    g_thread_join(job->thread_);
+    while (g_idle_remove_by_data(job)) {}
+    (void) removeDir(job->dumping_path_);
+    delete job;
+  }
+  dumping_.clear();
+}
+
+void NativeAppCheckpointer::Init() {
+
+  if (!SettingsImpl::instance().use_criu_checkpoint_) return;
+
+#ifndef HAVE_LIBCRIU
+  LOG_WARNING(MSGID_HANDLE_CRIU, 1, PMLOGKS("status", "checkpoint_disabled"), "sam is built without libcriu");
+  return;
+#endif
+
+  const std::string& base_path = SettingsImpl::instance().criu_image_base_path_;
+  if (!makeDir(base_path)) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("status", "fail_to_make_image_base"),
+                                      PMLOGKS("path", base_path.c_str()), "errno: %d", errno);
+    return;
+  }
+
+  // dumps interrupted by sam restart leave incomplete images behind
+  DIR* dir = opendir(base_path.c_str());
+  if (dir != NULL) {
+    std::string suffix(DUMPING_SUFFIX);
+    struct dirent* entry = NULL;
+    while ((entry = readdir(dir)) != NULL) {
+      std::string name(entry->d_name);
+      if (name.size() > suffix.size() &&
+          name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+        (void) removeDir(base_path + "/" + name);
+      }
+    }
+    closedir(dir);
+  }
+
+  AppLifeManager::instance().signal_app_life_status_changed.connect(
+      boost::bind(&NativeAppCheckpointer::OnLifeStatusChanged, this, _1, _2));
+  ApplicationManager::instance().signal_app_status_changed.connect(
+      boost::bind(&NativeAppCheckpointer::OnAppStatusChanged, this, _1, _2));
+
+  enabled_ = true;
+  LOG_INFO(MSGID_HANDLE_CRIU, 3, PMLOGKS("status", "checkpoint_enabled"),
+                                 PMLOGKS("ready_state", SettingsImpl::instance().criu_checkpoint_ready_state_.c_str()),
+                                 PMLOGKS("path", base_path.c_str()), "");
+}
+
+std::string NativeAppCheckpointer::GetImages(AppDescPtr app_desc) {
+
+  if (!enabled_ || !app_desc || !SettingsImpl::instance().SupportCRIU(app_desc->id())) return "";
+
+  std::string images_path = ImagesPath(app_desc->id());
+  if (!dir_exists(images_path)) return "";
+
+  std::string stamp = read_file(images_path + STAMP_FILE);
+  if (stamp.empty() || stamp != MakeStamp(app_desc)) {
+    LOG_INFO(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_desc->id().c_str()),
+                                   PMLOGKS("status", "stale_image"), "stamp: %s", stamp.c_str());
+    Discard(app_desc->id());
+    return "";
+  }
+  return images_path;
+}
+
+pid_t NativeAppCheckpointer::Restore(const std::string& images_path) {
+
+#ifdef HAVE_LIBCRIU
+  int dir_fd = open(images_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd < 0) return -1;
+
+  criu_opts* opts = NULL;
+  if (criu_local_init_opts(&opts) != 0) {
+    close(dir_fd);
+    return -1;
+  }
+  criu_local_set_images_dir_fd(opts, dir_fd);
+  criu_local_set_shell_job(opts, true);
+  (void) criu_local_set_log_file(opts, RESTORE_LOG_FILE);
+
+  // restored process tree becomes child of sam, same as spawned one
+  int pid = criu_local_restore_child(opts);
+  criu_local_free_opts(opts);
+  close(dir_fd);
+  return pid > 0 ? (pid_t) pid : -1;
+#else
+  return -1;
+#endif
+}
+
+bool NativeAppCheckpointer::DumpImages(pid_t pid, const std::string& images_path) {
+
+#ifdef HAVE_LIBCRIU
+  int dir_fd = open(images_path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+  if (dir_fd < 0) return false;
+
+  criu_opts* opts = NULL;
+  if (criu_local_init_opts(&opts) != 0) {
+    close(dir_fd);
+    return false;
+  }
+  criu_local_set_pid(opts, pid);
+  criu_local_set_images_dir_fd(opts, dir_fd);
+  criu_local_set_leave_running(opts, true);
+  criu_local_set_shell_job(opts, true);
+  (void) criu_local_set_log_file(opts, DUMP_LOG_FILE);
+
+  int result = criu_local_dump(opts);
+  criu_local_free_opts(opts);
+  close(dir_fd);
+  return result >= 0;
+#else
+  return false;
+#endif
+}
+
+void NativeAppCheckpointer::OnLaunched(AppDescPtr app_desc, pid_t pid, bool restored) {
+
+  if (!enabled_ || restored || !app_desc || !SettingsImpl::instance().SupportCRIU(app_desc->id())) return;
+
+  const std::string& app_id = app_desc->id();
+  if (dumping_.count(app_id) > 0) return;
+  if (!GetImages(app_desc).empty()) return;
+
+  std::string stamp = MakeStamp(app_desc);
+  if (stamp.empty()) return;
+
+  CancelPending(app_id);
+  PendingItem item;
+  item.pid_ = pid;
+  item.stamp_ = stamp;
+  item.timer_ = 0;
+  pending_[app_id] = item;
+}
+
+void NativeAppCheckpointer::Discard(const std::string& app_id) {
+
+  std::string images_path = ImagesPath(app_id);
+  if (!dir_exists(images_path)) return;
+
+  if (!removeDir(images_path)) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_id.c_str()),
+                                      PMLOGKS("status", "fail_to_discard_image"), "errno: %d", errno);
+    return;
+  }
+  LOG_INFO(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_id.c_str()),
+                                 PMLOGKS("status", "discarded_image"), "");
+}
+
+std::string NativeAppCheckpointer::MakeStamp(AppDescPtr app_desc) {
+
+  // store apps are replaced folder by folder, so mtime of folder is taken as install time
+  struct stat st;
+  if (stat(app_desc->folderPath().c_str(), &st) != 0) return "";
+  return app_desc->version() + "@" + toSTLString((long long) st.st_mtime);
+}
+
+gboolean NativeAppCheckpointer::OnReadyTimeout(gpointer user_data) {
+
+  std::string app_id = static_cast<const char*>(user_data);
+  NativeAppCheckpointer& checkpointer = NativeAppCheckpointer::instance();
+
+  auto it = checkpointer.pending_.find(app_id);
+  if (it == checkpointer.pending_.end()) return FALSE;
+
+  // source is removed by returning FALSE
+  it->second.timer_ = 0;
+  checkpointer.StartDump(app_id);
+  return FALSE;
+}
+
+gpointer NativeAppCheckpointer::DumpThread(gpointer user_data) {
+
+  // only job is touched here, everything else is handled on main loop
+  DumpJob* job = static_cast<DumpJob*>(user_data);
+  job->success_ = DumpImages(job->pid_, job->dumping_path_);
+  g_idle_add(&NativeAppCheckpointer::OnDumpThreadDone, job);
+  return NULL;
+}
+
+gboolean NativeAppCheckpointer::OnDumpThreadDone(gpointer user_data) {
+
+  DumpJob* job = static_cast<DumpJob*>(user_data);
+  g_thread_join(job->thread_);
+
+  NativeAppCheckpointer& checkpointer = NativeAppCheckpointer::instance();
+  checkpointer.dumping_.erase(job->app_id_);
+  checkpointer.FinishDump(*job);
+  delete job;
+  return FALSE;
+}
+
+void NativeAppCheckpointer::OnLifeStatusChanged(const std::string& app_id, const LifeStatus& life_status) {
+
+  auto it = pending_.find(app_id);
+  if (it == pending_.end()) return;
+
+  if (LifeStatus::STOP == life_status || LifeStatus::CLOSING == life_status) {
+    CancelPending(app_id);
+    return;
+  }
+
+  std::string status = AppInfoManager::instance().life_status_to_string(life_status);
+  if (status != SettingsImpl::instance().criu_checkpoint_ready_state_) {
+    // app has to stay in ready state for whole delay
+    if (it->second.timer_ != 0) {
+      g_source_remove(it->second.timer_);
+      it->second.timer_ = 0;
+    }
+    return;
+  }
+
+  if (it->second.timer_ == 0) {
+    it->second.timer_ = g_timeout_add_full(G_PRIORITY_DEFAULT, SettingsImpl::instance().criu_checkpoint_delay_ms_,
+                                           OnReadyTimeout, g_strdup(app_id.c_str()), g_free);
+  }
+}
+
+void NativeAppCheckpointer::OnAppStatusChanged(AppStatusChangeEvent event, AppDescPtr app_desc) {
+
+  if (!app_desc) return;
+
+  switch (event) {
+    case AppStatusChangeEvent::APP_INSTALLED:
+    case AppStatusChangeEvent::APP_UNINSTALLED:
+    case AppStatusChangeEvent::UPDATE_COMPLETED:
+      CancelPending(app_desc->id());
+      Discard(app_desc->id());
+      break;
+    default:
+      break;
+  }
+}
+
+void NativeAppCheckpointer::CancelPending(const std::string& app_id) {
+
+  auto it = pending_.find(app_id);
+  if (it == pending_.end()) return;
+
+  if (it->second.timer_ != 0) g_source_remove(it->second.timer_);
+  pending_.erase(it);
+}
+
+void NativeAppCheckpointer::StartDump(const std::string& app_id) {
+
+  auto it = pending_.find(app_id);
+  if (it == pending_.end()) return;
+  PendingItem item = it->second;
+  pending_.erase(it);
+
+  // pid might be reused by another process if app has exited meanwhile
+  if (AppInfoManager::instance().pid(app_id) != toSTLString(item.pid_)) return;
+
+  std::string dumping_path = ImagesPath(app_id) + DUMPING_SUFFIX;
+  (void) removeDir(dumping_path);
+  if (!makeDir(dumping_path)) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_id.c_str()),
+                                      PMLOGKS("status", "fail_to_make_image_dir"), "errno: %d", errno);
+    return;
+  }
+
+  // sam is multithreaded, so dump isn't run in a forked copy of it
+  DumpJob* job = new DumpJob();
+  job->app_id_ = app_id;
+  job->stamp_ = item.stamp_;
+  job->dumping_path_ = dumping_path;
+  job->pid_ = item.pid_;
+  job->success_ = false;
+  job->thread_ = g_thread_try_new("criu_dump", &NativeAppCheckpointer::DumpThread, job, NULL);
+  if (job->thread_ == NULL) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_id.c_str()),
+                                      PMLOGKS("status", "fail_to_create_dump_thread"), "");
+    delete job;
+    (void) removeDir(dumping_path);
+    return;
+  }
+  dumping_[app_id] = job;
+
+  LOG_INFO(MSGID_HANDLE_CRIU, 3, PMLOGKS("app_id", app_id.c_str()),
+                                 PMLOGKS("status", "dump_started"),
+                                 PMLOGKFV("pid", "%d", item.pid_), "");
+}
+
+void NativeAppCheckpointer::FinishDump(const DumpJob& item) {
+
+  std::string images_path = ImagesPath(item.app_id_);
+  const std::string& dumping_path = item.dumping_path_;
+
+  if (!item.success_) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", item.app_id_.c_str()),
+                                      PMLOGKS("status", "fail_to_dump"), "");
+    (void) removeDir(dumping_path);
+    return;
+  }
+
+  // app can be updated while it's being dumped
+  AppDescPtr app_desc = ApplicationManager::instance().getAppById(item.app_id_);
+  if (!app_desc || MakeStamp(app_desc) != item.stamp_) {
+    LOG_INFO(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", item.app_id_.c_str()),
+                                   PMLOGKS("status", "app_changed_on_dump"), "");
+    (void) removeDir(dumping_path);
+    return;
+  }
+
+  // image shows up by rename, so incomplete image is never restored
+  Discard(item.app_id_);
+  if (!writeFile(dumping_path + STAMP_FILE, item.stamp_) ||
+      rename(dumping_path.c_str(), images_path.c_str()) != 0) {
+    LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", item.app_id_.c_str()),
+                                      PMLOGKS("status", "fail_to_save_image"), "errno: %d", errno);
+    (void) removeDir(dumping_path);
+    return;
+  }
+
+  LOG_INFO(MSGID_HANDLE_CRIU, 3, PMLOGKS("app_id", item.app_id_.c_str()),
+                                 PMLOGKS("status", "saved_image"),
+                                 PMLOGKS("stamp", item.stamp_.c_str()), "");
+}
+
+std::string NativeAppCheckpointer::ImagesPath(const std::string& app_id) const {
+  return SettingsImpl::instance().criu_image_base_path_ + "/" + app_id;
+}
@@ -0,0 +1,91 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CHECKPOINTER_H_
+#define CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CHECKPOINTER_H_
+
+#include <glib.h>
+#include <sys/types.h>
+
+#include <map>
+#include <string>
+
+#include "core/base/singleton.h"
+#include "core/lifecycle/app_life_status.h"
+#include "core/package/application_manager.h"
+
+// Dumps CRIU images of apps in CRIUSupportApps once they stay in configured
+// ready state after a cold launch, so that next cold launch restores them.
+// Images are stamped with app version and install time of app folder,
+// and they are discarded when app is updated or restoring fails.
+// Dump runs on a worker thread to keep main loop going; result is handled
+// back on main loop.
+// Images are made and restored with libcriu (local API, so that dump thread
+// doesn't share options with main loop). Without libcriu at build time
+// checkpointing stays disabled.
+class NativeAppCheckpointer : public Singleton<NativeAppCheckpointer> {
+ public:
+  NativeAppCheckpointer();
+  ~NativeAppCheckpointer();
+
+  void Init();
+
+  // images directory to restore from, empty if there's no valid image
+  std::string GetImages(AppDescPtr app_desc);
+  // restores images of GetImages, returns pid of restored main process or -1
+  pid_t Restore(const std::string& images_path);
+  // called for each spawned or restored main process
+  void OnLaunched(AppDescPtr app_desc, pid_t pid, bool restored);
+  void Discard(const std::string& app_id);
+
+ private:
+  friend class Singleton<NativeAppCheckpointer>;
+
+  struct PendingItem {
+    pid_t       pid_;
+    std::string stamp_;
+    guint       timer_;
+  };
+
+  struct DumpJob {
+    std::string app_id_;
+    std::string stamp_;
+    std::string dumping_path_;
+    pid_t       pid_;
+    GThread*    thread_;
+    bool        success_;
+  };
+
+  static std::string MakeStamp(AppDescPtr app_desc);
+  static bool DumpImages(pid_t pid, const std::string& images_path);
+  static gboolean OnReadyTimeout(gpointer user_data);
+  static gpointer DumpThread(gpointer user_data);
+  static gboolean OnDumpThreadDone(gpointer user_data);
+
+  void OnLifeStatusChanged(const std::string& app_id, const LifeStatus& life_status);
+  void OnAppStatusChanged(AppStatusChangeEvent event, AppDescPtr app_desc);
+  void CancelPending(const std::string& app_id);
+  void StartDump(const std::string& app_id);
+  void FinishDump(const DumpJob& job);
+
+  std::string ImagesPath(const std::string& app_id) const;
+
+  bool enabled_;
+  std::map<std::string, PendingItem> pending_;  // app_id -> launched process waiting for dump
+  std::map<std::string, DumpJob*> dumping_;     // app_id -> dump in progress
+};
+
+#endif  // CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_CHECKPOINTER_H_
@@ -0,0 +1,379 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/life_handler/native_app_zygote.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "core/base/logging.h"
+#include "core/lifecycle/life_handler/native_app_cgroup.h"
+#include "core/lifecycle/life_handler/native_process_supervisor.h"
+
+#define ZYGOTE_REQUEST_MAX_SIZE   65536
+#define ZYGOTE_MAX_ARGS           64
+#define ZYGOTE_MAX_ENVS           256
+#define ZYGOTE_REPLY_TIMEOUT      200   // 200 ms, main loop is blocked while waiting
+#define ZYGOTE_REAP_INTERVAL      1000  // 1 sec
+#define ZYGOTE_MAX_FD             65536
+
+// request: header, then NUL terminated cgroup.procs path, argv and envp
+struct ZygoteRequestHeader {
+  uint32_t argc;
+  uint32_t envc;
+};
+
+// reply: pid of launched process or errno, pidfd is attached as SCM_RIGHTS
+struct ZygoteReply {
+  int32_t pid;
+  int32_t err;
+};
+
+static void SendReply(int socket_fd, const ZygoteReply& reply, int pidfd) {
+
+  struct iovec iov;
+  iov.iov_base = (void*) &reply;
+  iov.iov_len = sizeof(reply);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  memset(control, 0, sizeof(control));
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+
+  if (pidfd >= 0) {
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &pidfd, sizeof(int));
+  }
+
+  (void) sendmsg(socket_fd, &msg, MSG_NOSIGNAL);
+}
+
+NativeAppZygote::NativeAppZygote()
+    : socket_fd_(-1),
+      helper_pid_(-1) {
+}
+
+NativeAppZygote::~NativeAppZygote() {
+  Stop();
+}
+
+bool NativeAppZygote::Start(const std::vector<std::string>& warm_paths) {
+
+  if (IsStarted()) return true;
+
+  // launched processes can be supervised only through pidfd
+  int self_pidfd = NativeProcessSupervisor::OpenPidfd(getpid());
+  if (self_pidfd < 0) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "pidfd_not_supported"), "errno: %d", errno);
+    return false;
+  }
+  close(self_pidfd);
+
+  // prepared before fork, helper must not allocate
+  std::vector<const char*> paths;
+  for (const auto& path : warm_paths) {
+    if (!path.empty()) paths.push_back(path.c_str());
+  }
+  paths.push_back(NULL);
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0, fds) != 0) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "fail_to_make_socket"), "errno: %d", errno);
+    return false;
+  }
+
+  pid_t pid = fork();
+  if (pid < 0) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "fail_to_fork"), "errno: %d", errno);
+    close(fds[0]);
+    close(fds[1]);
+    return false;
+  }
+
+  if (pid == 0) {
+    close(fds[0]);
+    RunHelper(fds[1], paths.data());
+  }
+
+  close(fds[1]);
+  socket_fd_ = fds[0];
+  helper_pid_ = pid;
+
+  LOG_INFO(MSGID_LAUNCH_ZYGOTE, 2, PMLOGKS("status", "started"), PMLOGKFV("pid", "%d", (int) pid), "");
+  return true;
+}
+
+void NativeAppZygote::Stop() {
+
+  if (socket_fd_ >= 0) {
+    close(socket_fd_);
+    socket_fd_ = -1;
+  }
+
+  // apps launched by helper keep running, they're supervised through pidfd
+  if (helper_pid_ > 0) {
+    (void) kill(helper_pid_, SIGKILL);
+    (void) waitpid(helper_pid_, NULL, 0);
+    helper_pid_ = -1;
+  }
+}
+
+pid_t NativeAppZygote::Launch(const char** argv, const char** envp, const std::string& cgroup_procs, int& r_pidfd) {
+
+  r_pidfd = -1;
+  if (!IsStarted() || argv == NULL || argv[0] == NULL) return -1;
+
+  ZygoteRequestHeader header = { 0, 0 };
+  std::string strings = cgroup_procs;
+  strings.push_back('\0');
+  for (const char** arg = argv; *arg; ++arg, ++header.argc) {
+    strings.append(*arg);
+    strings.push_back('\0');
+  }
+  for (const char** env = envp; env && *env; ++env, ++header.envc) {
+    strings.append(*env);
+    strings.push_back('\0');
+  }
+
+  if (header.argc > ZYGOTE_MAX_ARGS || header.envc > ZYGOTE_MAX_ENVS ||
+      sizeof(header) + strings.size() >= ZYGOTE_REQUEST_MAX_SIZE) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "too_large_request"), "argc: %u", header.argc);
+    return -1;
+  }
+
+  std::string request((const char*) &header, sizeof(header));
+  request.append(strings);
+
+  if (send(socket_fd_, request.data(), request.size(), MSG_NOSIGNAL) != (ssize_t) request.size()) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "fail_to_send"), "errno: %d", errno);
+    Stop();
+    return -1;
+  }
+
+  struct pollfd pfd = { socket_fd_, POLLIN, 0 };
+  int ret = 0;
+  while ((ret = poll(&pfd, 1, ZYGOTE_REPLY_TIMEOUT)) < 0 && errno == EINTR) {}
+  if (ret <= 0) {
+    // helper only forks and waits for exec, so slow reply means it's stuck.
+    // late reply would be taken for next request, so helper is dropped
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "no_reply"), "ret: %d", ret);
+    Stop();
+    return -1;
+  }
+
+  ZygoteReply reply = { -1, 0 };
+  struct iovec iov;
+  iov.iov_base = &reply;
+  iov.iov_len = sizeof(reply);
+
+  char control[CMSG_SPACE(sizeof(int))];
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+
+  if (recvmsg(socket_fd_, &msg, MSG_CMSG_CLOEXEC) != (ssize_t) sizeof(reply)) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 1, PMLOGKS("status", "fail_to_receive"), "errno: %d", errno);
+    Stop();
+    return -1;
+  }
+
+  struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  if (cmsg && cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+    memcpy(&r_pidfd, CMSG_DATA(cmsg), sizeof(int));
+  }
+
+  if (reply.pid <= 0) {
+    LOG_WARNING(MSGID_LAUNCH_ZYGOTE, 2, PMLOGKS("status", "fail_to_launch"),
+                                        PMLOGKS("path", argv[0]), "errno: %d", (int) reply.err);
+    if (r_pidfd >= 0) close(r_pidfd);
+    r_pidfd = -1;
+    return -1;
+  }
+
+  return (pid_t) reply.pid;
+}
+
+void NativeAppZygote::RunHelper(int socket_fd, const char* const* warm_paths) {
+
+  // handlers of sam must not run in helper and launched apps
+  for (int sig = 1; sig < NSIG; ++sig) {
+    (void) signal(sig, SIG_DFL);
+  }
+  sigset_t empty_mask;
+  sigemptyset(&empty_mask);
+  sigprocmask(SIG_SETMASK, &empty_mask, NULL);
+
+  // nothing of sam is used here except socket
+  if (socket_fd != STDERR_FILENO + 1) {
+    dup2(socket_fd, STDERR_FILENO + 1);
+    socket_fd = STDERR_FILENO + 1;
+  }
+#ifdef SYS_close_range
+  if (syscall(SYS_close_range, socket_fd + 1, ~0U, 0) != 0)
+#endif
+  {
+    long max_fd = sysconf(_SC_OPEN_MAX);
+    if (max_fd < 0 || max_fd > ZYGOTE_MAX_FD) max_fd = ZYGOTE_MAX_FD;
+    for (int fd = socket_fd + 1; fd < max_fd; ++fd) close(fd);
+  }
+
+  // launcher binaries are kept open so that their pages stay in page cache
+  for (const char* const* path = warm_paths; *path; ++path) {
+    int fd = open(*path, O_RDONLY | O_CLOEXEC);
+    if (fd >= 0) (void) posix_fadvise(fd, 0, 0, POSIX_FADV_WILLNEED);
+  }
+
+  static char request[ZYGOTE_REQUEST_MAX_SIZE];
+  while (true) {
+    struct pollfd pfd = { socket_fd, POLLIN, 0 };
+    int ret = poll(&pfd, 1, ZYGOTE_REAP_INTERVAL);
+
+    // exited apps are reaped only here, so pidfd is always opened before it
+    while (waitpid(-1, NULL, WNOHANG) > 0) {}
+
+    if (ret < 0 && errno != EINTR) break;
+    if (ret <= 0) continue;
+
+    ssize_t size = recv(socket_fd, request, sizeof(request) - 1, 0);
+    if (size < 0 && errno == EINTR) continue;
+    if (size <= 0) break;  // sam closed socket
+
+    request[size] = '\0';
+    HandleRequest(socket_fd, request, (size_t) size);
+  }
+
+  _exit(0);
+}
+
+void NativeAppZygote::HandleRequest(int socket_fd, char* request, size_t size) {
+
+  static char* argv[ZYGOTE_MAX_ARGS + 1];
+  static char* envp[ZYGOTE_MAX_ENVS + 1];
+
+  ZygoteReply reply = { -1, EINVAL };
+
+  ZygoteRequestHeader header;
+  if (size < sizeof(header)) {
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+  memcpy(&header, request, sizeof(header));
+  if (header.argc == 0 || header.argc > ZYGOTE_MAX_ARGS || header.envc > ZYGOTE_MAX_ENVS) {
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+
+  char* pos = request + sizeof(header);
+  char* end = request + size;
+  auto next_string = [&pos, end]() -> char* {
+    if (pos >= end) return NULL;
+    char* str = pos;
+    char* nul = (char*) memchr(pos, '\0', end - pos);
+    if (nul == NULL) return NULL;
+    pos = nul + 1;
+    return str;
+  };
+
+  char* cgroup_procs = next_string();
+  bool valid = (cgroup_procs != NULL);
+  for (uint32_t i = 0; valid && i < header.argc; ++i) {
+    argv[i] = next_string();
+    valid = (argv[i] != NULL);
+  }
+  for (uint32_t i = 0; valid && i < header.envc; ++i) {
+    envp[i] = next_string();
+    valid = (envp[i] != NULL);
+  }
+  if (!valid) {
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+  argv[header.argc] = NULL;
+  envp[header.envc] = NULL;
+
+  // exec failure is reported through close-on-exec pipe like g_spawn does
+  int pipe_fds[2];
+  if (pipe2(pipe_fds, O_CLOEXEC) != 0) {
+    reply.err = errno;
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+
+  pid_t pid = fork();
+  if (pid == 0) {
+    close(pipe_fds[0]);
+    close(socket_fd);
+    if (cgroup_procs[0] != '\0') NativeAppCgroup::EnterInChild(cgroup_procs);
+
+    int null_fd = open("/dev/null", O_WRONLY);
+    if (null_fd >= 0) {
+      dup2(null_fd, STDOUT_FILENO);
+      dup2(null_fd, STDERR_FILENO);
+      if (null_fd > STDERR_FILENO) close(null_fd);
+    }
+
+    execve(argv[0], argv, header.envc > 0 ? envp : environ);
+    int err = errno;
+    (void) write(pipe_fds[1], &err, sizeof(err));
+    _exit(127);
+  }
+
+  close(pipe_fds[1]);
+  if (pid < 0) {
+    reply.err = errno;
+    close(pipe_fds[0]);
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+
+  int exec_err = 0;
+  ssize_t read_size = 0;
+  while ((read_size = read(pipe_fds[0], &exec_err, sizeof(exec_err))) < 0 && errno == EINTR) {}
+  close(pipe_fds[0]);
+
+  if (read_size == (ssize_t) sizeof(exec_err)) {
+    (void) waitpid(pid, NULL, 0);
+    reply.err = exec_err;
+    SendReply(socket_fd, reply, -1);
+    return;
+  }
+
+  // child is not reaped yet, so pid still refers to it
+  int pidfd = NativeProcessSupervisor::OpenPidfd(pid);
+  reply.pid = pid;
+  reply.err = 0;
+  SendReply(socket_fd, reply, pidfd);
+  if (pidfd >= 0) close(pidfd);
+}
@@ -0,0 +1,55 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_ZYGOTE_H_
+#define CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_ZYGOTE_H_
+
+#include <sys/types.h>
+
+#include <string>
+#include <vector>
+
+#include "core/base/singleton.h"
+
+// Helper process forked from sam at start up, while sam is still small.
+// It launches native apps on request over a socket pair, so launching doesn't pay
+// fork cost of grown sam, and keeps launcher binaries (app shell, qml-runner, jailer)
+// open so that they stay in page cache.
+// Launched processes are not children of sam, so helper passes pidfd of each one
+// and sam supervises them through it. Launch returns -1 whenever helper cannot be used,
+// then caller should spawn the process by itself.
+class NativeAppZygote : public Singleton<NativeAppZygote> {
+ public:
+  NativeAppZygote();
+  ~NativeAppZygote();
+
+  bool Start(const std::vector<std::string>& warm_paths);
+  void Stop();
+  bool IsStarted() const { return socket_fd_ >= 0; }
+
+  pid_t Launch(const char** argv, const char** envp, const std::string& cgroup_procs, int& r_pidfd);
+
+ private:
+  friend class Singleton<NativeAppZygote>;
+
+  static void RunHelper(int socket_fd, const char* const* warm_paths) __attribute__((noreturn));
+  static void HandleRequest(int socket_fd, char* request, size_t size);
+
+  int socket_fd_;
+  pid_t helper_pid_;
+};
+
+#endif  // CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_APP_ZYGOTE_H_
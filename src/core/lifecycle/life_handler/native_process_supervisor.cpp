@@ -0,0 +1,133 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/life_handler/native_process_supervisor.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "core/base/logging.h"
+
+// syscall numbers are shared by every architecture since 5.1
+#ifndef SYS_pidfd_open
+#define SYS_pidfd_open 434
+#endif
+#ifndef SYS_pidfd_send_signal
+#define SYS_pidfd_send_signal 424
+#endif
+
+static int pidfd_send_signal(int pidfd, int sig) {
+  return (int) syscall(SYS_pidfd_send_signal, pidfd, sig, NULL, 0);
+}
+
+NativeProcessSupervisor::NativeProcessSupervisor()
+    : use_pidfd_(true) {
+}
+
+NativeProcessSupervisor::~NativeProcessSupervisor() {
+  while (!items_.empty()) {
+    Unwatch(items_.begin()->first);
+  }
+}
+
+int NativeProcessSupervisor::OpenPidfd(pid_t pid) {
+  return (int) syscall(SYS_pidfd_open, pid, 0);
+}
+
+void NativeProcessSupervisor::Watch(pid_t pid, int pidfd) {
+
+  WatchItem item;
+  item.pidfd_ = pidfd;
+  if (item.pidfd_ < 0 && use_pidfd_) {
+    item.pidfd_ = OpenPidfd(pid);
+    if (item.pidfd_ < 0 && errno == ENOSYS) {
+      LOG_INFO(MSGID_NATIVE_APP_HANDLER, 1, PMLOGKS("status", "pidfd_not_supported"), "fall back to child watch");
+      use_pidfd_ = false;
+    }
+  }
+
+  if (item.pidfd_ < 0) {
+    g_child_watch_add(pid, (GChildWatchFunc) NativeProcessSupervisor::OnChildWatch, (gpointer) this);
+    return;
+  }
+
+  item.channel_ = g_io_channel_unix_new(item.pidfd_);
+  g_io_channel_set_close_on_unref(item.channel_, TRUE);
+  item.source_ = g_io_add_watch(item.channel_, (GIOCondition) (G_IO_IN | G_IO_ERR | G_IO_HUP),
+                                OnPidfdEvent, (gpointer) this);
+  items_[pid] = item;
+}
+
+bool NativeProcessSupervisor::SendSignal(pid_t pid, int sig) const {
+
+  auto it = items_.find(pid);
+  if (it == items_.end() || it->second.pidfd_ < 0) {
+    return kill(pid, sig) == 0;
+  }
+  return pidfd_send_signal(it->second.pidfd_, sig) == 0;
+}
+
+gboolean NativeProcessSupervisor::OnPidfdEvent(GIOChannel* channel, GIOCondition condition, gpointer user_data) {
+
+  NativeProcessSupervisor* supervisor = static_cast<NativeProcessSupervisor*>(user_data);
+  int pidfd = g_io_channel_unix_get_fd(channel);
+
+  pid_t pid = 0;
+  for (const auto& it : supervisor->items_) {
+    if (it.second.pidfd_ == pidfd) {
+      pid = it.first;
+      break;
+    }
+  }
+  if (pid == 0) return FALSE;
+
+  // pidfd becomes readable when process exits, then it's reaped here
+  // because processes are spawned with G_SPAWN_DO_NOT_REAP_CHILD
+  int status = 0;
+  pid_t result = waitpid(pid, &status, WNOHANG);
+  if (result == 0) return TRUE;
+  // processes launched by zygote are not children of sam, their exit status is unknown
+  if (result < 0) status = -1;
+
+  // source is removed by returning FALSE
+  supervisor->items_[pid].source_ = 0;
+  supervisor->HandleExited(pid, status);
+  return FALSE;
+}
+
+void NativeProcessSupervisor::OnChildWatch(GPid pid, gint status, gpointer user_data) {
+  g_spawn_close_pid(pid);
+  static_cast<NativeProcessSupervisor*>(user_data)->HandleExited(pid, status);
+}
+
+void NativeProcessSupervisor::HandleExited(pid_t pid, int status) {
+  Unwatch(pid);
+  signal_process_exited(pid, status);
+}
+
+void NativeProcessSupervisor::Unwatch(pid_t pid) {
+
+  auto it = items_.find(pid);
+  if (it == items_.end()) return;
+
+  if (it->second.source_ != 0) g_source_remove(it->second.source_);
+  // closes pidfd as well
+  if (it->second.channel_) g_io_channel_unref(it->second.channel_);
+  items_.erase(it);
+}
@@ -0,0 +1,61 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_PROCESS_SUPERVISOR_H_
+#define CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_PROCESS_SUPERVISOR_H_
+
+#include <boost/signals2.hpp>
+#include <glib.h>
+#include <sys/types.h>
+
+#include <map>
+
+// Watches exit of spawned main processes through pidfd on glib main loop.
+// pidfd keeps referring to the same process even after its pid is recycled,
+// so signals sent with SendSignal never reach an unrelated process.
+// Kernels without pidfd_open (before 5.3) fall back to g_child_watch_add.
+class NativeProcessSupervisor {
+ public:
+  NativeProcessSupervisor();
+  ~NativeProcessSupervisor();
+
+  // pidfd is taken over if it's given, otherwise it's opened here
+  void Watch(pid_t pid, int pidfd = -1);
+  bool SendSignal(pid_t pid, int sig) const;
+
+  static int OpenPidfd(pid_t pid);
+
+  boost::signals2::signal<void (pid_t pid, int status)> signal_process_exited;
+
+ private:
+  struct WatchItem {
+    int         pidfd_;
+    GIOChannel* channel_;
+    guint       source_;
+    WatchItem() : pidfd_(-1), channel_(NULL), source_(0) {}
+  };
+
+  static gboolean OnPidfdEvent(GIOChannel* channel, GIOCondition condition, gpointer user_data);
+  static void OnChildWatch(GPid pid, gint status, gpointer user_data);
+
+  void HandleExited(pid_t pid, int status);
+  void Unwatch(pid_t pid);
+
+  bool use_pidfd_;  // turned off once kernel says pidfd is not supported
+  std::map<pid_t, WatchItem> items_;
+};
+
+#endif  // CORE_LIFECYCLE_LIFE_HANDLER_NATIVE_PROCESS_SUPERVISOR_H_
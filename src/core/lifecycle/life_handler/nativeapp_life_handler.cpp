@@ -19,6 +19,9 @@
 #include <criue.h>
 #include <ext/stdio_filebuf.h>
 #include <proc/readproc.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
 #include <boost/lexical_cast.hpp>
 
 #include "core/base/jutil.h"
@@ -27,6 +30,10 @@
 #include "core/base/utils.h"
 #include "core/lifecycle/app_info_manager.h"
 #include "core/lifecycle/application_errors.h"
+#include "core/lifecycle/launch_latency_tracer.h"
+#include "core/lifecycle/life_handler/native_app_cgroup.h"
+#include "core/lifecycle/life_handler/native_app_checkpointer.h"
+#include "core/lifecycle/life_handler/native_app_zygote.h"
 #include "core/package/application_description.h"
 #include "core/package/application_manager.h"
 #include "core/setting/settings.h"
@@ -35,13 +42,13 @@
 #define TIMEOUT_FOR_NOT_RESPONDING  10000 // 10 secs
 #define TIMEOUT_FOR_REGISTER_V2     3000  // 3 secs
 #define TIME_LIMIT_OF_APP_LAUNCHING 3000000000u // 3 secs
+#define KILL_TIMER_SLACK            50000000.0  // 50 msecs
 
 static PidVector FindChildPids(const std::string& pid);
 static std::string PidsToString(const PidVector& pids);
-static pid_t fork_process(const char **argv, const char **envp);
-static bool kill_processes(const PidVector& pids, int signame);
-
-static NativeAppLifeHandler* g_this = NULL;
+static pid_t fork_process(const char **argv, const char **envp, const std::string& cgroup_procs, int& r_pidfd);
+static pid_t posix_spawn_process(const char **argv, const char **envp);
+static bool kill_processes(const NativeProcessSupervisor& supervisor, const PidVector& pids, int signame);
 
 ////////////////////////////////////////////////////////////////
 // NativeAppLifeCycleInterface
@@ -206,7 +213,21 @@ void NativeAppLifeCycleInterface::LaunchAsCommon(NativeClientInfoPtr client, App
   // TODO: define whether CRIU is common feature or not
   //       If CRIU is tv specific feature, redesign for this codes
   // In GLD4TV, only support input common apps. Also those are jail apps
-  if (SettingsImpl::instance().SupportCRIU(app_desc->id()) && criue_check_images(fork_params[0])) {
+  bool restored = false;
+  std::string criu_images = NativeAppCheckpointer::instance().GetImages(app_desc);
+  if (!criu_images.empty()) {
+    pid = NativeAppCheckpointer::instance().Restore(criu_images);
+    if (pid <= 0) {
+      LOG_WARNING(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_desc->id().c_str()),
+                                        PMLOGKS("status", "failed_to_restore_checkpoint"), "pid: %d", pid);
+      // broken image is dumped again after this launch
+      NativeAppCheckpointer::instance().Discard(app_desc->id());
+    } else {
+      LOG_INFO(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_desc->id().c_str()),
+                                     PMLOGKS("status", "restored_checkpoint"), "pid: %d", pid);
+      restored = true;
+    }
+  } else if (SettingsImpl::instance().SupportCRIU(app_desc->id()) && criue_check_images(fork_params[0])) {
     int argc = 0;
     while (fork_params[argc] != NULL) argc++;
 
@@ -218,14 +239,19 @@ void NativeAppLifeCycleInterface::LaunchAsCommon(NativeClientInfoPtr client, App
     } else {
       LOG_INFO(MSGID_HANDLE_CRIU, 2, PMLOGKS("app_id", app_desc->id().c_str()),
                                       PMLOGKS("status", "restored_image"), "pid: %d", pid);
+      restored = true;
     }
   }
 
+  std::string cgroup_procs = NativeAppCgroup::instance().Prepare(item->uid());
+  int pidfd = -1;
+
   if (pid <= 0) {
-    pid = fork_process(fork_params, NULL);
+    pid = fork_process(fork_params, NULL, cgroup_procs, pidfd);
   }
 
   if (pid <= 0) {
+    NativeAppCgroup::instance().Discard(cgroup_procs);
     LOG_ERROR(MSGID_APPLAUNCH_ERR, 2, PMLOGKS("app_id", app_desc->id().c_str()),
                                       PMLOGKS("path", path.c_str()), "forked_pid: %d", pid);
     Parent()->signal_app_life_status_changed(item->app_id(), item->uid(), RuntimeStatus::STOP);
@@ -234,8 +260,12 @@ void NativeAppLifeCycleInterface::LaunchAsCommon(NativeClientInfoPtr client, App
     return;
   }
 
+  // spawned processes are already in cgroup, restored ones by CRIU are moved here
+  (void) NativeAppCgroup::instance().Attach(pid, cgroup_procs);
+
   // set watcher for the child's
-  g_child_watch_add( pid, (GChildWatchFunc) NativeAppLifeHandler::ChildProcessWatcher, NULL);
+  Parent()->process_supervisor_.Watch(pid, pidfd);
+  NativeAppCheckpointer::instance().OnLaunched(app_desc, pid, restored);
 
   double current_time = get_current_time();
   double elapsed_time = current_time - item->launch_start_time();
@@ -245,6 +275,9 @@ void NativeAppLifeCycleInterface::LaunchAsCommon(NativeClientInfoPtr client, App
                                   PMLOGKFV("start_time", "%f", item->launch_start_time()),
                                   PMLOGKFV("collapse_time", "%f", elapsed_time), "");
 
+  item->mark_time("process_spawned");
+  LaunchLatencyTracer::instance().MarkRegistrationPending(item->app_id(), current_time);
+
   std::string new_pid = boost::lexical_cast<std::string>(pid);
   item->set_pid(new_pid);
   client->SetPid(new_pid);
@@ -704,11 +737,15 @@ bool NativeClientInfo::SendEvent(pbnjson::JValue& payload) {
 ////////////////////////////////////////////////////////////////
 // NativeAppLifeHandler
 
-NativeAppLifeHandler::NativeAppLifeHandler() : native_handler_v1_(this), native_handler_v2_(this) {
-  g_this = this;
+NativeAppLifeHandler::NativeAppLifeHandler()
+    : kill_timer_source_(0), kill_timer_deadline_(0), native_handler_v1_(this), native_handler_v2_(this) {
+  process_supervisor_.signal_process_exited.connect([this](pid_t pid, int status) {
+    HandleClosedPid(std::to_string(pid), status);
+  });
 }
 
 NativeAppLifeHandler::~NativeAppLifeHandler() {
+  if (kill_timer_source_ != 0) g_source_remove(kill_timer_source_);
 }
 
 NativeClientInfoPtr NativeAppLifeHandler::MakeNewClientInfo(const std::string& app_id) {
@@ -853,6 +890,7 @@ void NativeAppLifeHandler::RegisterApp(const std::string& app_id, LSMessage* lsm
   }
 
   client_info->Register(lsmsg);
+  LaunchLatencyTracer::instance().RecordRegistration(app_id);
 
   pbnjson::JValue payload = pbnjson::Object();
   payload.put("returnValue", true);
@@ -944,7 +982,22 @@ void NativeAppLifeHandler::RemoveLaunchPendingItem(const std::string& app_id)
 ////////////////////////////////////////////////////////////////////
 /// native app main launcher
 ////////////////////////////////////////////////////////////////////
-pid_t fork_process(const char **argv, const char **envp) {
+pid_t fork_process(const char **argv, const char **envp, const std::string& cgroup_procs, int& r_pidfd) {
+  r_pidfd = -1;
+
+  // posix_spawn cannot join cgroup before exec, and processes forked before moving it
+  // would stay out of cgroup. Ways below join cgroup in child before exec.
+  if (SettingsImpl::instance().use_posix_spawn_ && cgroup_procs.empty()) {
+    pid_t spawned_pid = posix_spawn_process(argv, envp);
+    if (spawned_pid > 0) return spawned_pid;
+  }
+
+  // helper is slower than vfork based posix_spawn, but it doesn't copy page tables of grown sam as g_spawn does
+  if (NativeAppZygote::instance().IsStarted()) {
+    pid_t launched_pid = NativeAppZygote::instance().Launch(argv, envp, cgroup_procs, r_pidfd);
+    if (launched_pid > 0) return launched_pid;
+  }
+
   //TODO : Set child's working path
   GPid pid = -1;
   GError* gerr = NULL;
@@ -954,8 +1007,8 @@ pid_t fork_process(const char **argv, const char **envp) {
                               const_cast<char**>(argv),  // cmd arguments
                               const_cast<char**>(envp),  // environment variables
                               flags,
-                              NULL,
-                              NULL,
+                              cgroup_procs.empty() ? NULL : NativeAppCgroup::EnterInChild,
+                              cgroup_procs.empty() ? NULL : (gpointer) cgroup_procs.c_str(),
                               &pid,
                               NULL,
                               NULL,
@@ -979,12 +1032,52 @@ pid_t fork_process(const char **argv, const char **envp) {
   return pid;
 }
 
-bool kill_processes(const PidVector& pids, int sig) {
+// posix_spawn of glibc runs child with vfork semantics (CLONE_VM | CLONE_VFORK),
+// so it doesn't copy page tables of sam which get larger as app and mime tables grow.
+// Child is made same as g_spawn_async_with_pipes does: stdout/stderr to /dev/null,
+// every descriptor except stdio closed and environment inherited if envp is NULL.
+pid_t posix_spawn_process(const char **argv, const char **envp) {
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 34)
+  posix_spawn_file_actions_t actions;
+  posix_spawnattr_t attr;
+  sigset_t empty_mask;
+
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+  posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+  posix_spawn_file_actions_addclosefrom_np(&actions, STDERR_FILENO + 1);
+
+  sigemptyset(&empty_mask);
+  posix_spawnattr_init(&attr);
+  posix_spawnattr_setsigmask(&attr, &empty_mask);
+  posix_spawnattr_setflags(&attr, POSIX_SPAWN_SETSIGMASK);
+
+  pid_t pid = -1;
+  int err = posix_spawn(&pid, argv[0], &actions, &attr,
+                        const_cast<char**>(argv), envp ? const_cast<char**>(envp) : environ);
+
+  posix_spawnattr_destroy(&attr);
+  posix_spawn_file_actions_destroy(&actions);
+
+  if (err != 0) {
+    LOG_WARNING(MSGID_APPLAUNCH_ERR, 2, PMLOGKS("reason", "posix_spawn_fail"),
+                                        PMLOGKS("where", "posix_spawn_process"),
+                                        "err: %d, fall back to g_spawn", err);
+    return -1;
+  }
+  return pid;
+#else
+  // descriptors of sam cannot be closed in child without posix_spawn_file_actions_addclosefrom_np
+  return -1;
+#endif
+}
+
+bool kill_processes(const NativeProcessSupervisor& supervisor, const PidVector& pids, int sig) {
   auto it = pids.begin();
   if (it == pids.end()) return true;
 
   // first process is parent process, killing child processes later can fail if parent itself terminates them
-  bool success = kill(*it, sig) == 0;
+  bool success = supervisor.SendSignal(*it, sig);
   while (++it != pids.end()) {
     kill(*it, sig);
   }
@@ -1006,7 +1099,12 @@ bool NativeAppLifeHandler::SendSystemSignal(const PidVector& pids, int signame)
     return false;
   }
 
-  if (!kill_processes(pids, signame)) {
+  // cgroup.kill reaches every process of app including ones forked after pids were collected
+  if (signame == SIGKILL && NativeAppCgroup::instance().Kill(pids.front())) {
+    return true;
+  }
+
+  if (!kill_processes(process_supervisor_, pids, signame)) {
     LOG_ERROR(MSGID_APPCLOSE_ERR, 2, PMLOGKS("reason", "seding_signal_error"), PMLOGKS("where", __FUNCTION__), "signame: %d", signame);
     return false;
   }
@@ -1021,10 +1119,10 @@ void NativeAppLifeHandler::StartTimerToKillApp(const std::string& app_id, const
                                         PMLOGKS("status", "start_kill_timer"),
                                         "pid: %s", pid.c_str());
 
-  KillingDataPtr target_item = std::make_shared<KillingData>(app_id, pid, all_pids);
-  target_item->timer_source_ = g_timeout_add(timeout, NativeAppLifeHandler::KillAppOnTimeout,
-                                             (gpointer)target_item.get());
+  double deadline = get_current_time() + (double) timeout * 1000000.0;
+  KillingDataPtr target_item = std::make_shared<KillingData>(app_id, (pid_t) std::atol(pid.c_str()), all_pids, deadline);
   killing_list_.push_back(target_item);
+  ScheduleKillTimer();
 }
 
 void NativeAppLifeHandler::StopTimerToKillApp(const std::string& app_id) {
@@ -1041,25 +1139,55 @@ void NativeAppLifeHandler::StopTimerToKillApp(const std::string& app_id) {
   RemoveKillingData(app_id);
 }
 
-gboolean NativeAppLifeHandler::KillAppOnTimeout(gpointer user_data) {
+void NativeAppLifeHandler::ScheduleKillTimer() {
 
-  if (user_data == NULL) {
-    LOG_ERROR(MSGID_APPCLOSE_ERR, 2, PMLOGKS("status", "null_user_data"), PMLOGKS("where", __FUNCTION__), "");
-    return FALSE;
+  if (killing_list_.empty()) {
+    if (kill_timer_source_ != 0) g_source_remove(kill_timer_source_);
+    kill_timer_source_ = 0;
+    return;
   }
 
-  KillingData* killing_item = static_cast<KillingData*>(user_data);
-  if (killing_item == NULL) {
-    LOG_ERROR(MSGID_APPCLOSE_ERR, 2, PMLOGKS("status", "null_killing_item"), PMLOGKS("where", __FUNCTION__), "");
-    return FALSE;
+  double earliest = killing_list_.front()->deadline_;
+  for (const auto& item : killing_list_) {
+    earliest = std::min(earliest, item->deadline_);
   }
 
-  LOG_INFO(MSGID_NATIVE_APP_HANDLER, 2, PMLOGKS("app_id", killing_item->app_id_.c_str()),
-                                        PMLOGKS("status", "kill_process"),
-                                        "");
+  // keep current timer if it fires early enough
+  if (kill_timer_source_ != 0 && kill_timer_deadline_ <= earliest) return;
+
+  if (kill_timer_source_ != 0) g_source_remove(kill_timer_source_);
+
+  double now = get_current_time();
+  guint interval = (earliest > now) ? (guint) ((earliest - now) / 1000000.0) : 0;
+  kill_timer_deadline_ = earliest;
+  kill_timer_source_ = g_timeout_add(interval, NativeAppLifeHandler::KillAppOnTimeout, (gpointer) this);
+}
+
+gboolean NativeAppLifeHandler::KillAppOnTimeout(gpointer user_data) {
+
+  NativeAppLifeHandler* handler = static_cast<NativeAppLifeHandler*>(user_data);
+  handler->kill_timer_source_ = 0;
+
+  // items expiring close together (e.g. many apps closed at once) are handled by one wakeup
+  double limit = get_current_time() + KILL_TIMER_SLACK;
+
+  auto it = handler->killing_list_.begin();
+  while (it != handler->killing_list_.end()) {
+    KillingDataPtr killing_item = *it;
+    if (killing_item->deadline_ > limit) {
+      ++it;
+      continue;
+    }
+
+    LOG_INFO(MSGID_NATIVE_APP_HANDLER, 2, PMLOGKS("app_id", killing_item->app_id_.c_str()),
+                                          PMLOGKS("status", "kill_process"),
+                                          "");
 
-  g_this->SendSystemSignal(killing_item->all_pids_, SIGKILL);
+    it = handler->killing_list_.erase(it);
+    handler->SendSystemSignal(killing_item->all_pids_, SIGKILL);
+  }
 
+  handler->ScheduleKillTimer();
   return FALSE;
 }
 
@@ -1074,17 +1202,21 @@ void NativeAppLifeHandler::RemoveKillingData(const std::string& app_id) {
   auto it = killing_list_.begin();
   while (it != killing_list_.end()) {
     if (app_id == (*it)->app_id_) {
-      g_source_remove((*it)->timer_source_);
-      (*it)->timer_source_ = 0;
       it = killing_list_.erase(it);
     } else {
       ++it;
     }
   }
+
+  ScheduleKillTimer();
 }
 
 PidVector FindChildPids(const std::string& pid) {
   PidVector pids;
+  if (NativeAppCgroup::instance().GetPids((pid_t)std::atol(pid.c_str()), pids)) {
+    return pids;
+  }
+
   pids.push_back((pid_t)std::atol(pid.c_str()));
 
   proc_t **proctab = readproctab(PROC_FILLSTAT);
@@ -1128,15 +1260,12 @@ static std::string PidsToString(const PidVector& pids) {
 ////////////////////////////////////////////////////////////////////
 /// native app process watcher
 ////////////////////////////////////////////////////////////////////
-void NativeAppLifeHandler::ChildProcessWatcher(GPid pid, gint status, gpointer data) {
-  g_spawn_close_pid( pid );
-  g_this->HandleClosedPid(boost::lexical_cast<std::string>(pid), status);
-}
-
 void NativeAppLifeHandler::HandleClosedPid(const std::string& pid, gint status) {
 
   LOG_INFO(MSGID_APPCLOSE, 1, PMLOGKS("closed_pid", pid.c_str()), "");
 
+  NativeAppCgroup::instance().Remove((pid_t)std::atol(pid.c_str()));
+
   NativeClientInfoPtr client = GetNativeClientInfoByPid(pid);
   if (client == nullptr) {
     LOG_ERROR(MSGID_APPCLOSE_ERR, 3, PMLOGKS("pid", pid.c_str()), PMLOGKS("reason", "empty_client_info"), PMLOGKS("where", __FUNCTION__), "");
@@ -22,26 +22,21 @@
 #include <vector>
 
 #include "core/lifecycle/life_handler/life_handler_interface.h"
+#include "core/lifecycle/life_handler/native_process_supervisor.h"
 
 typedef std::vector<pid_t> PidVector;
 
 class KillingData
 {
 public:
-    KillingData(const std::string& app_id, const std::string& pid, const PidVector& all_pids)
-        : app_id_(app_id), pid_(pid), all_pids_(all_pids), timer_source_(0) {}
-    ~KillingData() {
-      if(timer_source_ != 0) {
-        g_source_remove(timer_source_);
-        timer_source_ = 0;
-      }
-    }
+    KillingData(const std::string& app_id, pid_t pid, const PidVector& all_pids, double deadline)
+        : app_id_(app_id), pid_(pid), all_pids_(all_pids), deadline_(deadline) {}
 
 public:
     std::string app_id_;
-    std::string pid_;
+    pid_t       pid_;
     PidVector   all_pids_;
-    guint       timer_source_;
+    double      deadline_;  // monotonic time to send SIGKILL
 };
 typedef std::shared_ptr<KillingData> KillingDataPtr;
 
@@ -213,6 +208,7 @@ class NativeAppLifeHandler: public AppLifeHandlerInterface {
   void StartTimerToKillApp(const std::string& app_id, const std::string& pid,
       const PidVector& all_pids, guint timeout);
   void StopTimerToKillApp(const std::string& app_id);
+  void ScheduleKillTimer();
   static gboolean KillAppOnTimeout(gpointer user_data);
 
   NativeClientInfoPtr MakeNewClientInfo(const std::string& app_id);
@@ -222,7 +218,6 @@ class NativeAppLifeHandler: public AppLifeHandlerInterface {
   void RemoveNativeClientInfo(const std::string& app_id);
   void PrintNativeClients();
 
-  static void ChildProcessWatcher(GPid pid, gint status, gpointer data);
   void HandleClosedPid(const std::string& pid, gint status);
 
   void HandlePendingQOnRegistered(const std::string& app_id);
@@ -231,6 +226,9 @@ class NativeAppLifeHandler: public AppLifeHandlerInterface {
 
   // variables
   std::list<KillingDataPtr>         killing_list_;
+  guint                             kill_timer_source_;  // one timer for every killing item
+  double                            kill_timer_deadline_;
+  NativeProcessSupervisor           process_supervisor_;
   std::list<AppLaunchingItemPtr>    launch_pending_queue_;
   std::vector<NativeClientInfoPtr>  active_clients_;
 
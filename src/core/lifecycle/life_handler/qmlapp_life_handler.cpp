@@ -98,6 +98,7 @@ void QmlAppLifeHandler::launch(AppLaunchingItemPtr item)
                                     PMLOGKFV("start_time", "%f", item->launch_start_time()),
                                     PMLOGKFV("collapse_time", "%f", elapsed_time), "");
 
+    item->mark_time("booster_requested");
     item->set_return_token(token);
     m_lscall_request_list.push_back(item);
 }
@@ -173,6 +174,7 @@ bool QmlAppLifeHandler::cb_return_booster_launch(LSHandle* handle, LSMessage* ls
     LOG_INFO(MSGID_APPLAUNCH, 2, PMLOGKS("app_id", app_id.c_str()), PMLOGKS("status", "booster_launched_app"), "");
 
     item->set_pid(pid);
+    item->mark_time("booster_replied");
     g_this->signal_running_app_added(app_id, pid, "");
     g_this->signal_app_life_status_changed(app_id, "", RuntimeStatus::RUNNING);
 
@@ -101,6 +101,7 @@ void WebAppLifeHandler::launch(AppLaunchingItemPtr item)
                                     PMLOGKFV("start_time", "%f", item->launch_start_time()),
                                     PMLOGKFV("collapse_time", "%f", elapsed_time), "");
 
+    item->mark_time("wam_requested");
     item->set_return_token(token);
     m_lscall_request_list.push_back(item);
 }
@@ -158,6 +159,7 @@ bool WebAppLifeHandler::cb_return_for_launch_request(LSHandle* handle, LSMessage
     LOG_INFO(MSGID_APPLAUNCH, 2, PMLOGKS("app_id", app_id.c_str()), PMLOGKS("status", "received_launch_return_from_wam"), "");
 
     item->set_pid(proc_id);
+    item->mark_time("wam_replied");
     g_this->signal_launching_done(item->uid());
 
     return true;
@@ -0,0 +1,214 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/lifecycle/memory_reclaimer.h"
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <fstream>
+#include <set>
+
+#include "core/base/logging.h"
+#include "core/base/utils.h"
+#include "core/lifecycle/app_info_manager.h"
+#include "core/lifecycle/app_life_manager.h"
+#include "core/setting/settings.h"
+
+static const char* RECLAIM_CALLER_ID = "com.webos.applicationManager";
+static const char* RECLAIM_REASON = "memoryReclaim";
+
+MemoryReclaimer::MemoryReclaimer()
+    : meminfo_path_("/proc/meminfo"),
+      idle_source_(0),
+      requested_kb_(0),
+      reclaim_count_(0),
+      closed_app_count_(0),
+      last_result_(pbnjson::Object()) {
+}
+
+MemoryReclaimer::~MemoryReclaimer() {
+  if (idle_source_ != 0) g_source_remove(idle_source_);
+}
+
+pbnjson::JValue MemoryReclaimer::Reclaim(uint64_t target_kb, bool dry_run, const std::string& launching_app_id) {
+
+  if (target_kb == 0) target_kb = SettingsImpl::instance().memory_reclaim_target_kb_;
+
+  pbnjson::JValue result = pbnjson::Object();
+  result.put("dryRun", dry_run);
+  result.put("targetKB", (int64_t) target_kb);
+
+  uint64_t available_kb = 0;
+  if (!read_mem_available(meminfo_path_, available_kb)) {
+    LOG_WARNING(MSGID_MEMORY_RECLAIM, 1, PMLOGKS("status", "no_meminfo"), "");
+    result.put("errorText", "cannot read meminfo");
+    return result;
+  }
+  result.put("availableKB", (int64_t) available_kb);
+
+  std::vector<Candidate> candidates;
+  CollectCandidates(launching_app_id, candidates);
+
+  std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+    if (a.keep_alive_ != b.keep_alive_) return !a.keep_alive_;
+    if (a.last_foreground_time_ != b.last_foreground_time_) return a.last_foreground_time_ < b.last_foreground_time_;
+    return a.rss_kb_ > b.rss_kb_;
+  });
+
+  // RSS is estimation of memory freed by closing app, real amount shows up in next reclaim
+  uint64_t estimated_kb = available_kb;
+  unsigned int max_apps = SettingsImpl::instance().memory_reclaim_max_apps_;
+  double now = get_current_time();
+
+  pbnjson::JValue j_candidates = pbnjson::Array();
+  std::vector<std::string> selected_apps;
+  for (const auto& candidate : candidates) {
+    bool selected = (estimated_kb < target_kb && selected_apps.size() < max_apps);
+    if (selected) {
+      estimated_kb += candidate.rss_kb_;
+      selected_apps.push_back(candidate.app_id_);
+    }
+
+    pbnjson::JValue j_candidate = pbnjson::Object();
+    j_candidate.put("appId", candidate.app_id_);
+    j_candidate.put("pid", candidate.pid_);
+    j_candidate.put("rssKB", (int64_t) candidate.rss_kb_);
+    j_candidate.put("keepAlive", candidate.keep_alive_);
+    if (candidate.last_foreground_time_ > 0)
+      j_candidate.put("backgroundMs", (int64_t) ((now - candidate.last_foreground_time_) / 1000000.0));
+    j_candidate.put("selected", selected);
+    j_candidates.append(j_candidate);
+  }
+
+  result.put("candidates", j_candidates);
+  result.put("estimatedAvailableKB", (int64_t) estimated_kb);
+
+  if (!dry_run) {
+    ++reclaim_count_;
+    for (const auto& app_id : selected_apps) {
+      LOG_INFO(MSGID_MEMORY_RECLAIM, 3, PMLOGKS("app_id", app_id.c_str()),
+                                        PMLOGKS("status", "close_for_reclaim"),
+                                        PMLOGKFV("available_kb", "%llu", (unsigned long long) available_kb), "");
+      std::string err_text;
+      AppLifeManager::instance().close_by_app_id(app_id, RECLAIM_CALLER_ID, RECLAIM_REASON, err_text);
+      if (err_text.empty()) ++closed_app_count_;
+    }
+    last_result_ = result;
+  }
+
+  return result;
+}
+
+pbnjson::JValue MemoryReclaimer::Status() const {
+
+  pbnjson::JValue status = pbnjson::Object();
+  status.put("enabled", SettingsImpl::instance().use_memory_reclaim_);
+  status.put("targetKB", (int64_t) SettingsImpl::instance().memory_reclaim_target_kb_);
+  status.put("maxApps", (int) SettingsImpl::instance().memory_reclaim_max_apps_);
+  status.put("reclaimCount", (int) reclaim_count_);
+  status.put("closedAppCount", (int) closed_app_count_);
+
+  uint64_t available_kb = 0;
+  if (read_mem_available(meminfo_path_, available_kb))
+    status.put("availableKB", (int64_t) available_kb);
+
+  status.put("lastReclaim", last_result_);
+  return status;
+}
+
+void MemoryReclaimer::RequestReclaim(const std::string& app_id, uint64_t required_kb) {
+
+  if (!SettingsImpl::instance().use_memory_reclaim_) return;
+
+  // requests are handled later, they come in the middle of launching sequence
+  requested_app_id_ = app_id;
+  requested_kb_ = std::max(requested_kb_, required_kb);
+  if (idle_source_ == 0)
+    idle_source_ = g_idle_add(MemoryReclaimer::OnIdleReclaim, (gpointer) this);
+}
+
+gboolean MemoryReclaimer::OnIdleReclaim(gpointer user_data) {
+
+  MemoryReclaimer* reclaimer = static_cast<MemoryReclaimer*>(user_data);
+  reclaimer->idle_source_ = 0;
+
+  uint64_t available_kb = 0;
+  if (read_mem_available(reclaimer->meminfo_path_, available_kb)) {
+    (void) reclaimer->Reclaim(available_kb + reclaimer->requested_kb_, false, reclaimer->requested_app_id_);
+  }
+
+  reclaimer->requested_app_id_.clear();
+  reclaimer->requested_kb_ = 0;
+  return FALSE;
+}
+
+void MemoryReclaimer::CollectCandidates(const std::string& launching_app_id, std::vector<Candidate>& candidates) {
+
+  std::vector<std::string> launching_app_ids;
+  AppLifeManager::instance().get_launching_app_ids(launching_app_ids);
+  std::set<std::string> launching_apps(launching_app_ids.begin(), launching_app_ids.end());
+  launching_apps.insert(launching_app_id);
+
+  std::vector<std::string> running_app_ids;
+  AppInfoManager::instance().get_running_app_ids(running_app_ids);
+
+  // several apps can share a process (e.g. web apps), then its RSS is counted once
+  std::set<std::string> counted_pids;
+
+  for (const auto& app_id : running_app_ids) {
+    if (launching_apps.count(app_id) > 0) continue;
+    if (AppInfoManager::instance().is_app_on_foreground(app_id)) continue;
+    if (LifeStatus::BACKGROUND != AppInfoManager::instance().life_status(app_id)) continue;
+
+    Candidate candidate;
+    candidate.app_id_ = app_id;
+    candidate.pid_ = AppInfoManager::instance().pid(app_id);
+    candidate.rss_kb_ = 0;
+    candidate.last_foreground_time_ = AppInfoManager::instance().last_foreground_time(app_id);
+    candidate.keep_alive_ = SettingsImpl::instance().IsKeepAliveApp(app_id);
+
+    if (!candidate.pid_.empty() && counted_pids.insert(candidate.pid_).second)
+      (void) ReadRss(candidate.pid_, candidate.rss_kb_);
+
+    candidates.push_back(candidate);
+  }
+}
+
+bool MemoryReclaimer::ReadRss(const std::string& pid, uint64_t& r_kb) {
+
+  // smaps_rollup is cheaper than smaps and more accurate than status (since linux 4.14)
+  std::ifstream rollup(("/proc/" + pid + "/smaps_rollup").c_str());
+  std::ifstream status;
+  std::istream* input = &rollup;
+  const char* format = "Rss: %llu kB";
+  if (!rollup.is_open()) {
+    status.open(("/proc/" + pid + "/status").c_str());
+    if (!status.is_open()) return false;
+    input = &status;
+    format = "VmRSS: %llu kB";
+  }
+
+  std::string line;
+  while (std::getline(*input, line)) {
+    unsigned long long kb = 0;
+    if (sscanf(line.c_str(), format, &kb) == 1) {
+      r_kb = kb;
+      return true;
+    }
+  }
+  return false;
+}
@@ -0,0 +1,74 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_LIFECYCLE_MEMORY_RECLAIMER_H_
+#define CORE_LIFECYCLE_MEMORY_RECLAIMER_H_
+
+#include <glib.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include <pbnjson.hpp>
+
+#include "core/base/singleton.h"
+
+// Closes background apps in least valuable first order until MemAvailable
+// reaches target level. Apps are ranked by keep-alive status (kept longer),
+// last time in foreground (older first) and then RSS (bigger first).
+// Dry run reports what would be closed without closing anything.
+class MemoryReclaimer : public Singleton<MemoryReclaimer> {
+ public:
+  MemoryReclaimer();
+  ~MemoryReclaimer();
+
+  // target_kb 0 means configured MemoryReclaimTargetKB
+  pbnjson::JValue Reclaim(uint64_t target_kb, bool dry_run, const std::string& launching_app_id = "");
+  pbnjson::JValue Status() const;
+
+  // launching of app_id is waiting for required_kb more memory
+  void RequestReclaim(const std::string& app_id, uint64_t required_kb);
+
+  // same file as memory admission reads, so both see one (fixture) meminfo
+  void SetMeminfoPath(const std::string& meminfo_path) { meminfo_path_ = meminfo_path; }
+
+ private:
+  friend class Singleton<MemoryReclaimer>;
+
+  struct Candidate {
+    std::string app_id_;
+    std::string pid_;
+    uint64_t    rss_kb_;
+    double      last_foreground_time_;
+    bool        keep_alive_;
+  };
+
+  static bool ReadRss(const std::string& pid, uint64_t& r_kb);
+  static gboolean OnIdleReclaim(gpointer user_data);
+  void CollectCandidates(const std::string& launching_app_id, std::vector<Candidate>& candidates);
+
+  std::string meminfo_path_;
+  guint idle_source_;
+  std::string requested_app_id_;
+  uint64_t requested_kb_;
+
+  unsigned int reclaim_count_;
+  unsigned int closed_app_count_;
+  pbnjson::JValue last_result_;
+};
+
+#endif  // CORE_LIFECYCLE_MEMORY_RECLAIMER_H_
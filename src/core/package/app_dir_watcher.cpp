@@ -0,0 +1,234 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/package/app_dir_watcher.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "core/base/logging.h"
+
+static const char* APPINFO_FILE_NAME = "appinfo.json";
+
+static const uint32_t BASE_DIR_WATCH_MASK =
+    IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+static const uint32_t APP_DIR_WATCH_MASK =
+    IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_ONLYDIR;
+
+static void TrimPath(std::string &path) {
+  if (!path.empty() && path.back() == '/')
+    path.erase(std::prev(path.end()));
+}
+
+AppDirWatcher::AppDirWatcher()
+    : inotify_fd_(-1),
+      channel_(NULL),
+      io_source_(0),
+      debounce_source_(0),
+      debounce_ms_(0) {
+}
+
+AppDirWatcher::~AppDirWatcher() {
+  Stop();
+}
+
+bool AppDirWatcher::Start(const BaseScanPaths& base_dirs, unsigned int debounce_ms) {
+
+  if (IsStarted()) return true;
+
+  inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (inotify_fd_ < 0) {
+    LOG_WARNING(MSGID_APP_DIR_WATCHER, 1, PMLOGKS("status", "fail_to_init"), "errno: %d", errno);
+    return false;
+  }
+
+  debounce_ms_ = debounce_ms;
+  channel_ = g_io_channel_unix_new(inotify_fd_);
+  io_source_ = g_io_add_watch(channel_, (GIOCondition) (G_IO_IN | G_IO_ERR | G_IO_HUP),
+                              OnInotifyEvent, (gpointer) this);
+
+  for (const auto& it : base_dirs) {
+    AddBaseDirWatch(it.first);
+  }
+
+  LOG_INFO(MSGID_APP_DIR_WATCHER, 2, PMLOGKS("status", "started"),
+                                     PMLOGKFV("watches", "%d", (int) watch_items_.size()), "");
+  return true;
+}
+
+void AppDirWatcher::Stop() {
+
+  if (debounce_source_ != 0) {
+    g_source_remove(debounce_source_);
+    debounce_source_ = 0;
+  }
+
+  if (io_source_ != 0) {
+    g_source_remove(io_source_);
+    io_source_ = 0;
+  }
+
+  if (channel_) {
+    g_io_channel_unref(channel_);
+    channel_ = NULL;
+  }
+
+  if (inotify_fd_ >= 0) {
+    close(inotify_fd_);
+    inotify_fd_ = -1;
+  }
+
+  watch_items_.clear();
+  pending_app_ids_.clear();
+}
+
+void AppDirWatcher::Enqueue(const std::string& app_id) {
+
+  if (!IsStarted() || app_id.empty()) return;
+
+  pending_app_ids_.insert(app_id);
+
+  // restart timer on every event, so burst of changes results in one rescan
+  if (debounce_source_ != 0) g_source_remove(debounce_source_);
+  debounce_source_ = g_timeout_add(debounce_ms_, OnDebounceTimeout, (gpointer) this);
+}
+
+void AppDirWatcher::AddBaseDirWatch(const std::string& base_dir) {
+
+  std::string path = base_dir;
+  TrimPath(path);
+
+  int wd = inotify_add_watch(inotify_fd_, path.c_str(), BASE_DIR_WATCH_MASK);
+  if (wd < 0) {
+    // directories like dev or alias can be absent, they are covered by full scan
+    LOG_DEBUG("[AppDirWatcher] cannot watch %s, errno: %d", path.c_str(), errno);
+    return;
+  }
+  watch_items_[wd] = WatchItem(path, "");
+
+  dirent** app_dir_list = NULL;
+  int app_dir_num = scandir(path.c_str(), &app_dir_list, 0, alphasort);
+  if (app_dir_list == NULL) return;
+
+  for (int idx = 0 ; idx < app_dir_num ; ++idx) {
+    if (app_dir_list[idx]->d_name[0] != '.') {
+      AddAppDirWatch(path + "/" + app_dir_list[idx]->d_name, app_dir_list[idx]->d_name);
+    }
+    free(app_dir_list[idx]);
+  }
+  free(app_dir_list);
+}
+
+void AppDirWatcher::AddAppDirWatch(const std::string& app_dir, const std::string& app_id) {
+
+  int wd = inotify_add_watch(inotify_fd_, app_dir.c_str(), APP_DIR_WATCH_MASK);
+  if (wd < 0) {
+    LOG_DEBUG("[AppDirWatcher] cannot watch %s, errno: %d", app_dir.c_str(), errno);
+    return;
+  }
+  watch_items_[wd] = WatchItem(app_dir, app_id);
+}
+
+void AppDirWatcher::RemoveAppDirWatch(const std::string& app_dir) {
+
+  for (auto it = watch_items_.begin(); it != watch_items_.end(); ++it) {
+    if (it->second.app_id_.empty() || it->second.path_ != app_dir) continue;
+    // removal of already deleted directory fails, but it's harmless
+    (void) inotify_rm_watch(inotify_fd_, it->first);
+    watch_items_.erase(it);
+    return;
+  }
+}
+
+void AppDirWatcher::HandleEvents() {
+
+  char buf[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+  while (true) {
+    ssize_t len = read(inotify_fd_, buf, sizeof(buf));
+    if (len <= 0) break;
+
+    for (char* ptr = buf; ptr < buf + len; ptr += sizeof(struct inotify_event) + ((struct inotify_event*) ptr)->len) {
+      const struct inotify_event* event = (const struct inotify_event*) ptr;
+
+      if (event->mask & IN_Q_OVERFLOW) {
+        LOG_WARNING(MSGID_APP_DIR_WATCHER, 1, PMLOGKS("status", "event_overflow"), "");
+        signalEventOverflow();
+        continue;
+      }
+
+      auto item_it = watch_items_.find(event->wd);
+      if (item_it == watch_items_.end()) continue;
+
+      if (event->mask & IN_IGNORED) {
+        watch_items_.erase(item_it);
+        continue;
+      }
+
+      if (event->len == 0 || event->name[0] == '.') continue;
+
+      WatchItem item = item_it->second;
+      std::string name = event->name;
+
+      if (item.app_id_.empty()) {
+        // app directory is added or removed in base directory
+        std::string app_dir = item.path_ + "/" + name;
+        if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+          AddAppDirWatch(app_dir, name);
+        } else if (event->mask & (IN_DELETE | IN_MOVED_FROM)) {
+          RemoveAppDirWatch(app_dir);
+        }
+        Enqueue(name);
+      } else if (name == APPINFO_FILE_NAME) {
+        Enqueue(item.app_id_);
+      }
+    }
+  }
+}
+
+gboolean AppDirWatcher::OnInotifyEvent(GIOChannel* channel, GIOCondition condition, gpointer user_data) {
+
+  AppDirWatcher* watcher = static_cast<AppDirWatcher*>(user_data);
+
+  if (condition & (G_IO_ERR | G_IO_HUP)) {
+    LOG_WARNING(MSGID_APP_DIR_WATCHER, 1, PMLOGKS("status", "channel_closed"), "condition: %d", (int) condition);
+    watcher->io_source_ = 0;
+    return FALSE;
+  }
+
+  watcher->HandleEvents();
+  return TRUE;
+}
+
+gboolean AppDirWatcher::OnDebounceTimeout(gpointer user_data) {
+
+  AppDirWatcher* watcher = static_cast<AppDirWatcher*>(user_data);
+  watcher->debounce_source_ = 0;
+
+  // handlers can enqueue again (e.g. while full scan is running)
+  std::set<std::string> app_ids;
+  app_ids.swap(watcher->pending_app_ids_);
+
+  for (const auto& app_id : app_ids) {
+    LOG_INFO(MSGID_APP_DIR_WATCHER, 2, PMLOGKS("status", "changed"), PMLOGKS("app_id", app_id.c_str()), "");
+    watcher->signalAppDirChanged(app_id);
+  }
+
+  return FALSE;
+}
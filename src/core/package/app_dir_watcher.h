@@ -0,0 +1,71 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_PACKAGE_APP_DIR_WATCHER_H_
+#define CORE_PACKAGE_APP_DIR_WATCHER_H_
+
+#include <boost/signals2.hpp>
+#include <glib.h>
+#include <map>
+#include <set>
+#include <string>
+
+#include "core/package/app_scanner.h"
+
+// Watches app base directories and appinfo.json of each app directory with inotify.
+// Changed app ids are collected and emitted once after debounce interval,
+// so that caller can rescan only the changed apps instead of all directories.
+class AppDirWatcher {
+ public:
+  AppDirWatcher();
+  ~AppDirWatcher();
+
+  bool Start(const BaseScanPaths& base_dirs, unsigned int debounce_ms);
+  void Stop();
+  bool IsStarted() const { return inotify_fd_ >= 0; }
+
+  void Enqueue(const std::string& app_id);
+
+  boost::signals2::signal<void (const std::string& app_id)> signalAppDirChanged;
+  // events were dropped by kernel, so caller should fall back to full scan
+  boost::signals2::signal<void ()> signalEventOverflow;
+
+ private:
+  struct WatchItem {
+    std::string path_;
+    std::string app_id_;  // empty for base directory
+    WatchItem() {}
+    WatchItem(const std::string& path, const std::string& app_id) : path_(path), app_id_(app_id) {}
+  };
+
+  static gboolean OnInotifyEvent(GIOChannel* channel, GIOCondition condition, gpointer user_data);
+  static gboolean OnDebounceTimeout(gpointer user_data);
+
+  void AddBaseDirWatch(const std::string& base_dir);
+  void AddAppDirWatch(const std::string& app_dir, const std::string& app_id);
+  void RemoveAppDirWatch(const std::string& app_dir);
+  void HandleEvents();
+
+  int inotify_fd_;
+  GIOChannel* channel_;
+  guint io_source_;
+  guint debounce_source_;
+  unsigned int debounce_ms_;
+  std::map<int, WatchItem> watch_items_;
+  std::set<std::string> pending_app_ids_;
+};
+
+#endif // CORE_PACKAGE_APP_DIR_WATCHER_H_
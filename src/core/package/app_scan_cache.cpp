@@ -0,0 +1,173 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#include "core/package/app_scan_cache.h"
+
+#include <glib.h>
+#include <sys/stat.h>
+
+#include "core/base/jutil.h"
+#include "core/base/logging.h"
+#include "core/base/mutex_locker.h"
+#include "core/setting/settings.h"
+
+// bump this whenever the way LoadAppInfo builds appinfo is changed
+static const int APP_SCAN_CACHE_VERSION = 1;
+
+std::string AppScanCache::StatToString(const std::string& file_path) {
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0 || (file_stat.st_mode & S_IFREG) == 0)
+    return file_path + ":-";
+
+  return file_path + ":" + std::to_string((long long) file_stat.st_mtim.tv_sec) +
+                     "." + std::to_string((long long) file_stat.st_mtim.tv_nsec) +
+                     ":" + std::to_string((long long) file_stat.st_size);
+}
+
+AppScanCache::AppScanCache() : loaded_(false), dirty_(false) {
+}
+
+AppScanCache::~AppScanCache() {
+}
+
+std::string AppScanCache::MakeHeaderSignature() {
+  std::string schema_path = SettingsImpl::instance().schemaPath + "ApplicationDescription.schema";
+  return std::to_string(APP_SCAN_CACHE_VERSION) + "|" +
+         StatToString(schema_path) + "|" +
+         SettingsImpl::instance().app_paths_conf_;
+}
+
+std::string AppScanCache::MakeStamp(const std::string& prefix, const std::vector<std::string>& files,
+                                    std::map<std::string, std::string>& file_stats) {
+  std::string stamp = prefix;
+  for (const auto& file : files) {
+    auto it = file_stats.find(file);
+    if (it == file_stats.end()) it = file_stats.insert(std::make_pair(file, StatToString(file))).first;
+    stamp += "|" + it->second;
+  }
+  return stamp;
+}
+
+void AppScanCache::Load(const std::string& file_path) {
+  MutexLocker lock(&mutex_);
+
+  file_path_ = file_path;
+  signature_ = MakeHeaderSignature();
+  entries_.clear();
+  loaded_ = true;
+  dirty_ = false;
+
+  pbnjson::JValue root = JUtil::parseFile(file_path_, "");
+  if (root.isNull() || !root.isObject()) {
+    LOG_INFO(MSGID_APP_SCANNER, 2, PMLOGKS("scan_cache", "empty"),
+                                   PMLOGKS("path", file_path_.c_str()), "");
+    return;
+  }
+
+  if (root["signature"].asString() != signature_ || !root["apps"].isObject()) {
+    LOG_INFO(MSGID_APP_SCANNER, 2, PMLOGKS("scan_cache", "invalidated"),
+                                   PMLOGKS("path", file_path_.c_str()), "signature changed");
+    dirty_ = true;
+    return;
+  }
+
+  for (auto it : root["apps"].children()) {
+    if (!it.second.isObject() || !it.second["stamp"].isString() || !it.second["appinfo"].isObject())
+      continue;
+
+    Entry& entry = entries_[it.first.asString()];
+    entry.stamp_ = it.second["stamp"].asString();
+    entry.appinfo_ = it.second["appinfo"];
+  }
+
+  LOG_INFO(MSGID_APP_SCANNER, 2, PMLOGKS("scan_cache", "loaded"),
+                                 PMLOGKFV("entries", "%d", (int) entries_.size()), "");
+}
+
+void AppScanCache::Save() {
+  MutexLocker lock(&mutex_);
+
+  if (!loaded_ || !dirty_) return;
+
+  pbnjson::JValue apps = pbnjson::Object();
+  for (const auto& it : entries_) {
+    pbnjson::JValue entry = pbnjson::Object();
+    entry.put("stamp", it.second.stamp_);
+    entry.put("appinfo", it.second.appinfo_);
+    apps.put(it.first, entry);
+  }
+
+  pbnjson::JValue root = pbnjson::Object();
+  root.put("signature", signature_);
+  root.put("apps", apps);
+
+  std::string contents = JUtil::jsonToString(root);
+  if (!g_file_set_contents(file_path_.c_str(), contents.c_str(), contents.length(), NULL)) {
+    LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("scan_cache", "save_failed"),
+                                      PMLOGKS("path", file_path_.c_str()), "");
+    return;
+  }
+
+  dirty_ = false;
+}
+
+pbnjson::JValue AppScanCache::Lookup(const std::string& app_dir_path, const std::string& stamp) {
+  MutexLocker lock(&mutex_);
+
+  if (!loaded_) return pbnjson::JValue();
+
+  auto it = entries_.find(app_dir_path);
+  if (it == entries_.end() || it->second.stamp_ != stamp)
+    return pbnjson::JValue();
+
+  it->second.touched_ = true;
+  // callers modify loaded appinfo, so never hand out the cached one
+  return it->second.appinfo_.duplicate();
+}
+
+void AppScanCache::Store(const std::string& app_dir_path, const std::string& stamp, const pbnjson::JValue& appinfo) {
+  MutexLocker lock(&mutex_);
+
+  if (!loaded_) return;
+
+  Entry& entry = entries_[app_dir_path];
+  entry.stamp_ = stamp;
+  entry.appinfo_ = appinfo.duplicate();
+  entry.touched_ = true;
+  dirty_ = true;
+}
+
+void AppScanCache::ResetTouched() {
+  MutexLocker lock(&mutex_);
+
+  for (auto& it : entries_) {
+    it.second.touched_ = false;
+  }
+}
+
+void AppScanCache::RemoveUntouched() {
+  MutexLocker lock(&mutex_);
+
+  auto it = entries_.begin();
+  while (it != entries_.end()) {
+    if (it->second.touched_) {
+      ++it;
+      continue;
+    }
+    it = entries_.erase(it);
+    dirty_ = true;
+  }
+}
@@ -0,0 +1,71 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+#ifndef CORE_PACKAGE_APP_SCAN_CACHE_H_
+#define CORE_PACKAGE_APP_SCAN_CACHE_H_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <pbnjson.hpp>
+
+#include "core/base/mutex.h"
+
+// Persistent cache of loaded appinfo (localization applied) per app directory.
+// Each entry is validated by a stamp built from locale, type and mtime/size of
+// appinfo.json files. Whole cache is dropped if format version, schema file or
+// configured ApplicationPaths differ from what it was saved with.
+class AppScanCache {
+ public:
+  AppScanCache();
+  ~AppScanCache();
+
+  void Load(const std::string& file_path);
+  void Save();
+  bool IsLoaded() const { return loaded_; }
+
+  pbnjson::JValue Lookup(const std::string& app_dir_path, const std::string& stamp);
+  void Store(const std::string& app_dir_path, const std::string& stamp, const pbnjson::JValue& appinfo);
+
+  void ResetTouched();
+  void RemoveUntouched();
+
+  // file_stats keeps mtime/size of each file as it was when the file was read,
+  // files not in it yet are stat'ed now and added
+  static std::string MakeStamp(const std::string& prefix, const std::vector<std::string>& files,
+                               std::map<std::string, std::string>& file_stats);
+  static std::string StatToString(const std::string& file_path);
+
+ private:
+  struct Entry {
+    std::string     stamp_;
+    pbnjson::JValue appinfo_;
+    bool            touched_;
+    Entry() : touched_(false) {}
+  };
+
+  static std::string MakeHeaderSignature();
+
+  Mutex mutex_;
+  bool loaded_;
+  bool dirty_;
+  std::string file_path_;
+  std::string signature_;
+  std::map<std::string, Entry> entries_;
+};
+
+#endif // CORE_PACKAGE_APP_SCAN_CACHE_H_
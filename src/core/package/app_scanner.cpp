@@ -17,10 +17,12 @@
 #include "core/package/app_scanner.h"
 
 #include <dirent.h>
+#include <set>
 #include <sys/stat.h>
 
 #include "core/base/jutil.h"
 #include "core/base/logging.h"
+#include "core/base/mutex_locker.h"
 #include "core/setting/settings.h"
 
 static void TrimPath(std::string &path) {
@@ -31,13 +33,29 @@ static void TrimPath(std::string &path) {
 AppScanner::AppScanner()
     : app_desc_factory_(NULL),
       app_scan_filter_(NULL),
-      scan_mode_(ScanMode::NOT_RUNNING) {
+      scan_mode_(ScanMode::NOT_RUNNING),
+      pending_scan_mode_(ScanMode::NOT_RUNNING),
+      scan_thread_(NULL),
+      has_pending_locale_(false) {
 }
 
 AppScanner::~AppScanner() {
+  if (scan_thread_) {
+    g_thread_join(scan_thread_);
+    scan_thread_ = NULL;
+  }
 }
 
 void AppScanner::SetBCP47Info(const std::string& lang, const std::string& script, const std::string& region) {
+  // scan thread is reading locale now, apply it when scanning is done
+  if (isRunning()) {
+    pending_language_ = lang;
+    pending_script_   = script;
+    pending_region_   = region;
+    has_pending_locale_ = true;
+    return;
+  }
+
   language_ = lang;
   script_   = script;
   region_   = region;
@@ -74,6 +92,14 @@ void AppScanner::Run(ScanMode mode) {
   }
   if (ScanMode::FULL_SCAN != mode && ScanMode::PARTIAL_SCAN != mode) return;
 
+  // run again after current scanning, full scan covers partial scan
+  if (isRunning()) {
+    if (ScanMode::FULL_SCAN == mode || ScanMode::NOT_RUNNING == pending_scan_mode_)
+      pending_scan_mode_ = mode;
+    LOG_INFO(MSGID_APP_SCANNER, 1, PMLOGKS("status", "pending"), "scan mode: %d", (int) mode);
+    return;
+  }
+
   if (ScanMode::FULL_SCAN == mode) {
     for (auto& it: target_dirs_) {
       it.is_scanned_ = false;
@@ -86,6 +112,11 @@ void AppScanner::Run(ScanMode mode) {
     if (nothing_to_scan) return;
   }
 
+  if (!scan_cache_.IsLoaded() && SettingsImpl::instance().use_app_scan_cache_ &&
+      SettingsImpl::instance().isRestLoaded) {
+    scan_cache_.Load(SettingsImpl::instance().app_scan_cache_path_);
+  }
+
   app_desc_maps_.clear();
   scan_mode_ = mode;
 
@@ -94,21 +125,91 @@ void AppScanner::Run(ScanMode mode) {
 
 void AppScanner::RunScanner() {
 
+  if (ScanMode::FULL_SCAN == scan_mode_) scan_cache_.ResetTouched();
+
+  scan_tasks_.clear();
   for (auto& it : target_dirs_) {
     if (it.is_scanned_) continue;
 
-    ScanDir(it.path_, it.type_);
+    ScanDir(it.path_, it.type_, scan_tasks_);
     it.is_scanned_ = true;
   }
 
+  // load schema into cache here, so scan thread only reads the cache
+  JUtil::instance().loadSchema("ApplicationDescription", true);
+
+  // parse appinfo.json files off the main loop. current roster keeps serving
+  // requests until new one is built and signaled in FinishScanner
+  scan_thread_ = g_thread_try_new("app_scanner", &AppScanner::ScanThread, this, NULL);
+  if (scan_thread_ == NULL) {
+    LOG_WARNING(MSGID_APP_SCANNER, 1, PMLOGKS("status", "run_on_main_loop"), "failed to create scan thread");
+    LoadAppInfos(scan_tasks_);
+    FinishScanner();
+  }
+}
+
+gpointer AppScanner::ScanThread(gpointer user_data) {
+  AppScanner* scanner = static_cast<AppScanner*>(user_data);
+
+  scanner->LoadAppInfos(scanner->scan_tasks_);
+  g_idle_add(&AppScanner::OnScanThreadDone, scanner);
+  return NULL;
+}
+
+gboolean AppScanner::OnScanThreadDone(gpointer user_data) {
+  AppScanner* scanner = static_cast<AppScanner*>(user_data);
+
+  g_thread_join(scanner->scan_thread_);
+  scanner->scan_thread_ = NULL;
+
+  scanner->FinishScanner();
+  return FALSE;
+}
+
+void AppScanner::FinishScanner() {
+
+  // register results in scanning order to keep priority rules deterministic
+  for (auto& task : scan_tasks_) {
+    AppDescPtr new_app_desc = CreateAppDesc(task.jdesc_, task.app_id_, task.path_, task.type_);
+    RegisterNewAppDesc(new_app_desc, app_desc_maps_);
+  }
+
+  // drop entries of apps which are not on the file system anymore
+  if (ScanMode::FULL_SCAN == scan_mode_) {
+    scan_cache_.RemoveUntouched();
+
+    std::set<std::string> scanned_paths;
+    for (const auto& task : scan_tasks_) scanned_paths.insert(task.path_);
+
+    MutexLocker lock(&localization_mutex_);
+    for (auto it = localization_cache_.begin(); it != localization_cache_.end(); ) {
+      if (scanned_paths.count(it->first) == 0) it = localization_cache_.erase(it);
+      else ++it;
+    }
+  }
+  scan_cache_.Save();
+  scan_tasks_.clear();
+
   ScanMode scanned_mode = scan_mode_;
   scan_mode_ = ScanMode::NOT_RUNNING;
+
+  if (has_pending_locale_) {
+    has_pending_locale_ = false;
+    SetBCP47Info(pending_language_, pending_script_, pending_region_);
+  }
+
   signalAppScanFinished(scanned_mode, app_desc_maps_);
 
   app_desc_maps_.clear();
+
+  if (ScanMode::NOT_RUNNING != pending_scan_mode_) {
+    ScanMode next_mode = pending_scan_mode_;
+    pending_scan_mode_ = ScanMode::NOT_RUNNING;
+    Run(next_mode);
+  }
 }
 
-void AppScanner::ScanDir(std::string base_dir, AppTypeByDir type) {
+void AppScanner::ScanDir(std::string base_dir, AppTypeByDir type, std::vector<ScanTask>& tasks) {
   TrimPath(base_dir);
 
   int app_dir_num = 0;
@@ -123,8 +224,10 @@ void AppScanner::ScanDir(std::string base_dir, AppTypeByDir type) {
       if (app_dir_list[idx]->d_name[0] == '.') continue;
 
       std::string app_dir_path = base_dir + "/" + app_dir_list[idx]->d_name;
-      AppDescPtr new_app_desc = ScanApp(app_dir_path, type);
-      RegisterNewAppDesc(new_app_desc, app_desc_maps_);
+      std::string app_id;
+      if (!ValidateAppDir(app_dir_path, type, app_id)) continue;
+
+      tasks.push_back(ScanTask(app_dir_path, app_id, type));
     }
   }
 
@@ -137,41 +240,95 @@ void AppScanner::ScanDir(std::string base_dir, AppTypeByDir type) {
   }
 }
 
+void AppScanner::LoadAppInfoWorker(gpointer data, gpointer user_data) {
+  ScanTask* task = static_cast<ScanTask*>(data);
+  AppScanner* scanner = static_cast<AppScanner*>(user_data);
+  task->jdesc_ = scanner->LoadAppInfo(task->path_, task->type_);
+}
+
+void AppScanner::LoadAppInfos(std::vector<ScanTask>& tasks) {
+
+  unsigned int worker_num = SettingsImpl::instance().app_scan_worker_num_;
+  if (worker_num > tasks.size()) worker_num = tasks.size();
+
+  GThreadPool* pool = NULL;
+  if (worker_num > 1) {
+    GError* error = NULL;
+    pool = g_thread_pool_new(&AppScanner::LoadAppInfoWorker, this, worker_num, TRUE, &error);
+    if (pool == NULL) {
+      LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("status", "run_serially"),
+                                        PMLOGKFV("worker_num", "%u", worker_num),
+                                        "failed to create worker pool: %s", (error ? error->message : ""));
+      if (error) g_error_free(error);
+    }
+  }
+
+  if (pool == NULL) {
+    for (auto& task : tasks) {
+      task.jdesc_ = LoadAppInfo(task.path_, task.type_);
+    }
+    return;
+  }
+
+  for (auto& task : tasks) {
+    g_thread_pool_push(pool, &task, NULL);
+  }
+
+  // wait until all pushed tasks are done
+  g_thread_pool_free(pool, FALSE, TRUE);
+}
+
 AppDescPtr AppScanner::ScanApp(std::string& path, AppTypeByDir type) {
+
+  std::string app_id;
+  if (!ValidateAppDir(path, type, app_id)) {
+    return nullptr;
+  }
+
+  pbnjson::JValue jdesc = LoadAppInfo(path, type);
+  return CreateAppDesc(jdesc, app_id, path, type);
+}
+
+bool AppScanner::ValidateAppDir(std::string& path, AppTypeByDir type, std::string& app_id) {
   TrimPath(path);
 
   if (!app_desc_factory_) {
     LOG_WARNING(MSGID_APP_SCANNER, 1, PMLOGKS("status", "ignore"), "no_app_description_factory_registered");
-    return nullptr;
+    return false;
   }
 
   std::size_t pos = path.rfind("/");
   if (std::string::npos == pos || path.length() <= pos) {
     LOG_WARNING(MSGID_APP_SCANNER, 1, PMLOGKS("status", "ignore"), "invalid path: %s", path.c_str());
-    return nullptr;
+    return false;
   }
 
   struct stat dir_stat;
   if (stat(path.c_str(), &dir_stat) != 0 || (dir_stat.st_mode & S_IFDIR) == 0) {
     LOG_WARNING(MSGID_APP_SCANNER, 1, PMLOGKS("status", "ignore"), "app dir not exist: %s", path.c_str());
-    return nullptr;
+    return false;
   }
 
-  std::string app_id = path.substr(pos+1);
+  app_id = path.substr(pos+1);
 
   if (AppTypeByDir::System_BuiltIn == type) {
     if (SettingsImpl::instance().isDeletedSystemApp(app_id)) {
       LOG_INFO(MSGID_APP_SCANNER, 1, PMLOGKS("status", "skip"), "deleted system app: %s", path.c_str());
-      return nullptr;
+      return false;
     }
   }
 
   if (AppTypeByDir::Dev == type && !(SettingsImpl::instance().isDevMode)) {
     LOG_INFO(MSGID_APP_SCANNER, 1, PMLOGKS("status", "skip"), "dev app, but not in devmode now: %s", path.c_str());
-    return nullptr;
+    return false;
   }
 
-  pbnjson::JValue jdesc = LoadAppInfo(path, type);
+  return true;
+}
+
+AppDescPtr AppScanner::CreateAppDesc(pbnjson::JValue& jdesc, const std::string& app_id,
+                                     const std::string& path, AppTypeByDir type) {
+
   if (jdesc.isNull()) {
     return nullptr;
   }
@@ -238,7 +395,7 @@ AppDescPtr AppScanner::ScanForOneApp(const std::string& app_id) {
   return (tmp_roster.count(app_id) > 0) ? tmp_roster[app_id] : nullptr;
 }
 
-pbnjson::JValue AppScanner::LoadAppInfo(const std::string& app_dir_path, const AppTypeByDir& type_by_dir) {
+std::vector<std::string> AppScanner::GetLocalizationDirs(const std::string& app_dir_path) const {
 
   // Specify application description depending on available locale string.
   // This string is in BCP-47 format which can contain a language, language-region,
@@ -248,6 +405,29 @@ pbnjson::JValue AppScanner::LoadAppInfo(const std::string& app_dir_path, const A
   // or resources/<language>/<script>/<region>/appinfo.json respectively.
   // (Note that the script dir goes in between the language and region dirs.)
 
+  // Localization (base dir is ./resources/)
+  std::string resource_base_path = app_dir_path + "/resources/";
+  std::vector<std::string> localization_dirs;
+  localization_dirs.push_back(resource_base_path + language_ + "/");
+  localization_dirs.push_back(resource_base_path + language_ + "/" + region_ + "/");
+  localization_dirs.push_back(resource_base_path + language_ + "/" + script_ + "/" + region_ + "/");
+  return localization_dirs;
+}
+
+std::string AppScanner::MakeScanStamp(const std::string& app_dir_path, const AppTypeByDir& type_by_dir,
+                                      const std::vector<std::string>& localization_dirs,
+                                      std::map<std::string, std::string>& file_stats) const {
+
+  std::vector<std::string> appinfo_files { app_dir_path + "/appinfo.json" };
+  for (const auto& localization_dir : localization_dirs) {
+    appinfo_files.push_back(localization_dir + "appinfo.json");
+  }
+  return AppScanCache::MakeStamp(
+      std::to_string((int) type_by_dir) + "|" + language_ + "-" + script_ + "-" + region_, appinfo_files, file_stats);
+}
+
+pbnjson::JValue AppScanner::LoadBaseAppInfo(const std::string& app_dir_path, const AppTypeByDir& type_by_dir) {
+
   const std::string default_appinfo_path  = app_dir_path + "/appinfo.json";
 
   pbnjson::JValue root = JUtil::parseFile(default_appinfo_path, "ApplicationDescription");
@@ -273,69 +453,181 @@ pbnjson::JValue AppScanner::LoadAppInfo(const std::string& app_dir_path, const A
       root.put("installTime", (int32_t)(file_info.st_mtime));
   }
 
-  // Localization (base dir is ./resources/)
-  std::string resource_base_path = app_dir_path + "/resources/";
-  static const std::vector<std::string> prohibited_props {"id", "type", "trustLevel"};
-  static const std::vector<std::string> supporting_assets {"icon", "largeIcon", "bgImage", "splashBackground"};
-  static const std::vector<std::string> img_props {"icon", "miniicon", "mediumIcon", "largeIcon",
-                                               "splashicon", "splashBackground", "bgImage", "imageForRecents"};
+  return root;
+}
 
-  std::vector<std::string> localization_candidate_dirs;
-  localization_candidate_dirs.push_back(resource_base_path + language_ + "/");
-  localization_candidate_dirs.push_back(resource_base_path + language_ + "/" + region_ + "/");
-  localization_candidate_dirs.push_back(resource_base_path + language_ + "/" + script_ + "/" + region_ + "/");
+pbnjson::JValue AppScanner::LoadLocalization(const std::string& localization_dir) {
 
-  // apply localization  (overwrite from low to high)
-  for (const auto& localization_dir : localization_candidate_dirs) {
-    std::string appinfo_path = localization_dir + "appinfo.json";
-    std::string relative_path = localization_dir.substr(app_dir_path.length());
+  std::string appinfo_path = localization_dir + "appinfo.json";
 
-    struct stat file_stat;
-    if (stat(appinfo_path.c_str(), &file_stat) != 0 || (file_stat.st_mode & S_IFREG) == 0) continue;
+  struct stat file_stat;
+  if (stat(appinfo_path.c_str(), &file_stat) != 0 || (file_stat.st_mode & S_IFREG) == 0) {
+    return pbnjson::JValue();
+  }
 
-    pbnjson::JValue local_obj = JUtil::parseFile(appinfo_path, "");
+  pbnjson::JValue local_obj = JUtil::parseFile(appinfo_path, "");
 
-    if (local_obj.isNull()) {
-      LOG_INFO(MSGID_APP_SCANNER, 1, PMLOGKS("status", "ignore"),
-                                     "failed_to_load_localication: %s", localization_dir.c_str());
+  if (local_obj.isNull()) {
+    LOG_INFO(MSGID_APP_SCANNER, 1, PMLOGKS("status", "ignore"),
+                                   "failed_to_load_localication: %s", localization_dir.c_str());
+  }
+  return local_obj;
+}
+
+void AppScanner::ApplyLocalization(pbnjson::JValue& root, const pbnjson::JValue& local_obj,
+                                   const std::string& app_dir_path, const std::string& localization_dir) {
+
+  static const std::set<std::string> prohibited_props {"id", "type", "trustLevel"};
+  static const std::set<std::string> supporting_assets {"icon", "largeIcon", "bgImage", "splashBackground"};
+  static const std::set<std::string> img_props {"icon", "miniicon", "mediumIcon", "largeIcon",
+                                                "splashicon", "splashBackground", "bgImage", "imageForRecents"};
+
+  std::string relative_path = localization_dir.substr(app_dir_path.length());
+
+  for (auto json_it : local_obj.children()) {
+    std::string key = json_it.first.asString();
+
+    if (!root.hasKey(key) || root[key].getType() != local_obj[key].getType()) {
+      LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("localization", "unmatchted_with_root"),
+                                        PMLOGKS("key", key.c_str()),
+                                        "file: %sappinfo.json", localization_dir.c_str());
       continue;
     }
 
-    for (auto json_it : local_obj.children()) {
-      std::string key = json_it.first.asString();
+    if (prohibited_props.count(key) > 0) {
+      LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("localization", "prohibited_props"),
+                                        PMLOGKS("key", key.c_str()),
+                                        "file: %sappinfo.json", localization_dir.c_str());
+      continue;
+    }
 
-      if (!root.hasKey(key) || root[key].getType() != local_obj[key].getType()) {
-        LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("localization", "unmatchted_with_root"),
-                                          PMLOGKS("key", key.c_str()),
-                                          "file: %s", appinfo_path.c_str());
-        continue;
-      }
+    if (supporting_assets.count(key) > 0) {
+      // check asset variation rule with root value
+      std::string root_asset_value = root[key].asString();
+      std::string asset_value = local_obj[key].asString();
+      // if assets variation rule is specified, dont support localization
+      if (root_asset_value.length() > 0 && root_asset_value[0] == '$') continue;
+      if (asset_value.length() > 0 && asset_value[0] == '$') continue;
+    }
 
-      if (std::find(prohibited_props.begin(), prohibited_props.end(), key) != prohibited_props.end()) {
-        LOG_WARNING(MSGID_APP_SCANNER, 2, PMLOGKS("localization", "prohibited_props"),
-                                          PMLOGKS("key", key.c_str()),
-                                          "file: %s", appinfo_path.c_str());
-        continue;
-      }
+    if (img_props.count(key) > 0) {
+      std::string img_value = relative_path + local_obj[key].asString();
+      root.put(key, img_value);
+    } else {
+      root.put(key, local_obj[key]);
+    }
+  }
+}
 
-      if (std::find (supporting_assets.begin(), supporting_assets.end(), key) != supporting_assets.end()) {
-        // check asset variation rule with root value
-        std::string root_asset_value = root[key].asString();
-        std::string asset_value = local_obj[key].asString();
-        // if assets variation rule is specified, dont support localization
-        if (root_asset_value.length() > 0 && root_asset_value[0] == '$') continue;
-        if (asset_value.length() > 0 && asset_value[0] == '$') continue;
-      }
+pbnjson::JValue AppScanner::LoadAppInfo(const std::string& app_dir_path, const AppTypeByDir& type_by_dir) {
+
+  std::vector<std::string> localization_dirs = GetLocalizationDirs(app_dir_path);
+
+  // restore from scan cache if none of appinfo.json files are changed.
+  // files are stat'ed before they are read, so a change while reading makes stamp stale, not content
+  std::map<std::string, std::string> file_stats;
+  std::string stamp = MakeScanStamp(app_dir_path, type_by_dir, localization_dirs, file_stats);
+
+  pbnjson::JValue cached = scan_cache_.Lookup(app_dir_path, stamp);
+  if (!cached.isNull()) {
+    // base and overlays read before can be stale now, and their stats are not kept any more.
+    // entry is replaced, so relocalization reads them again from disk
+    LocalizationEntry entry;
+    entry.merged_ = cached.duplicate();
+    entry.file_stats_ = file_stats;
+
+    MutexLocker lock(&localization_mutex_);
+    localization_cache_[app_dir_path] = entry;
+    return cached;
+  }
+
+  pbnjson::JValue base = LoadBaseAppInfo(app_dir_path, type_by_dir);
+  if (base.isNull()) {
+    return pbnjson::JValue();
+  }
 
-      auto img_prop = std::find (img_props.begin(), img_props.end(), key);
-      if (img_prop != img_props.end()) {
-        std::string img_value = relative_path + local_obj[key].asString();
-        root.put(key, img_value);
-      } else {
-        root.put(key, local_obj[key]);
+  LocalizationEntry entry;
+  entry.base_ = base.duplicate();
+  entry.file_stats_ = file_stats;
+
+  // apply localization  (overwrite from low to high)
+  pbnjson::JValue root = base;
+  for (const auto& localization_dir : localization_dirs) {
+    pbnjson::JValue local_obj = LoadLocalization(localization_dir);
+    entry.localizations_[localization_dir] = local_obj;
+    if (local_obj.isNull()) continue;
+
+    ApplyLocalization(root, local_obj, app_dir_path, localization_dir);
+  }
+  entry.merged_ = root.duplicate();
+
+  {
+    MutexLocker lock(&localization_mutex_);
+    localization_cache_[app_dir_path] = entry;
+  }
+
+  scan_cache_.Store(app_dir_path, stamp, root);
+  return root;
+}
+
+AppDescMaps AppScanner::RelocalizeApps(const AppDescMaps& apps) {
+
+  AppDescMaps changed_apps;
+  if (!app_desc_factory_) return changed_apps;
+
+  for (const auto& it : apps) {
+    const std::string& app_dir_path = it.second->folderPath();
+    AppTypeByDir type_by_dir = it.second->getTypeByDir();
+
+    LocalizationEntry entry;
+    {
+      MutexLocker lock(&localization_mutex_);
+      auto entry_it = localization_cache_.find(app_dir_path);
+      if (entry_it != localization_cache_.end()) entry = entry_it->second;
+    }
+
+    // restored from scan cache, so base appinfo was not parsed yet
+    if (entry.base_.isNull()) {
+      std::string base_path = app_dir_path + "/appinfo.json";
+      entry.file_stats_[base_path] = AppScanCache::StatToString(base_path);
+      pbnjson::JValue base = LoadBaseAppInfo(app_dir_path, type_by_dir);
+      if (base.isNull()) continue;
+      entry.base_ = base;
+    }
+
+    // re-merge overlays of current locale in memory. overlay files are read
+    // only once per locale
+    std::vector<std::string> localization_dirs = GetLocalizationDirs(app_dir_path);
+    pbnjson::JValue root = entry.base_.duplicate();
+    for (const auto& localization_dir : localization_dirs) {
+      auto local_it = entry.localizations_.find(localization_dir);
+      if (local_it == entry.localizations_.end()) {
+        std::string local_path = localization_dir + "appinfo.json";
+        entry.file_stats_[local_path] = AppScanCache::StatToString(local_path);
+        local_it = entry.localizations_.insert(
+            std::make_pair(localization_dir, LoadLocalization(localization_dir))).first;
       }
+      if (local_it->second.isNull()) continue;
+
+      ApplyLocalization(root, local_it->second, app_dir_path, localization_dir);
+    }
+
+    // stamp of files as they were read, changed files are loaded again on next scan
+    scan_cache_.Store(app_dir_path, MakeScanStamp(app_dir_path, type_by_dir, localization_dirs, entry.file_stats_), root);
+
+    bool is_changed = (entry.merged_.isNull() || entry.merged_ != root);
+    entry.merged_ = root.duplicate();
+    {
+      MutexLocker lock(&localization_mutex_);
+      localization_cache_[app_dir_path] = entry;
     }
+
+    if (!is_changed) continue;
+
+    AppDescPtr new_desc = CreateAppDesc(root, it.first, app_dir_path, type_by_dir);
+    if (new_desc) changed_apps[it.first] = new_desc;
   }
 
-  return root;
+  scan_cache_.Save();
+  return changed_apps;
 }
@@ -18,9 +18,13 @@
 #define CORE_PACKAGE_APP_SCANNER_H_
 
 #include <boost/signals2.hpp>
+#include <glib.h>
+#include <map>
 #include <string>
 #include <vector>
 
+#include "core/base/mutex.h"
+#include "core/package/app_scan_cache.h"
 #include "core/package/application_description.h"
 #include "interface/package/appscan_filter_interface.h"
 #include "interface/package/app_description_factory_interface.h"
@@ -50,6 +54,8 @@ class AppScanner {
   bool isRunning() const;
   void Run(ScanMode mode);
   AppDescPtr ScanForOneApp(const std::string& app_id);
+  // rebuild given apps with current locale from cached appinfo, returns only changed ones
+  AppDescMaps RelocalizeApps(const AppDescMaps& apps);
 
   boost::signals2::signal<void (AppDescPtr, ScanMode)> signalAppDetected;
   boost::signals2::signal<void (ScanMode, const AppDescMaps&)> signalAppScanFinished;
@@ -62,20 +68,66 @@ class AppScanner {
     AppDir(const std::string& path, const AppTypeByDir& type):path_(path), type_(type), is_scanned_(false) {}
   };
 
+  // one app directory found while scanning. jdesc_ is filled by scan workers
+  struct ScanTask {
+    std::string     path_;
+    std::string     app_id_;
+    AppTypeByDir    type_;
+    pbnjson::JValue jdesc_;
+    ScanTask(const std::string& path, const std::string& app_id, const AppTypeByDir& type)
+        : path_(path), app_id_(app_id), type_(type) {}
+  };
+
+  // appinfo.json without localization, and localization overlays by dir (null if not exist),
+  // kept to re-merge them in memory on locale change
+  struct LocalizationEntry {
+    pbnjson::JValue base_;
+    pbnjson::JValue merged_;
+    std::map<std::string, pbnjson::JValue> localizations_;
+    std::map<std::string, std::string> file_stats_;  // appinfo.json path -> stat when it was read
+  };
+
+  static void LoadAppInfoWorker(gpointer data, gpointer user_data);
+  static gpointer ScanThread(gpointer user_data);
+  static gboolean OnScanThreadDone(gpointer user_data);
+
   void RunScanner();
-  void ScanDir(std::string base_dir, AppTypeByDir type);
+  void FinishScanner();
+  void ScanDir(std::string base_dir, AppTypeByDir type, std::vector<ScanTask>& tasks);
+  void LoadAppInfos(std::vector<ScanTask>& tasks);
   AppDescPtr ScanApp(std::string& path, AppTypeByDir type);
+  bool ValidateAppDir(std::string& path, AppTypeByDir type, std::string& app_id);
+  AppDescPtr CreateAppDesc(pbnjson::JValue& jdesc, const std::string& app_id,
+                           const std::string& path, AppTypeByDir type);
   pbnjson::JValue LoadAppInfo(const std::string& app_dir_path, const AppTypeByDir& type_by_dir);
+  pbnjson::JValue LoadBaseAppInfo(const std::string& app_dir_path, const AppTypeByDir& type_by_dir);
+  static pbnjson::JValue LoadLocalization(const std::string& localization_dir);
+  static void ApplyLocalization(pbnjson::JValue& root, const pbnjson::JValue& local_obj,
+                                const std::string& app_dir_path, const std::string& localization_dir);
+  std::vector<std::string> GetLocalizationDirs(const std::string& app_dir_path) const;
+  std::string MakeScanStamp(const std::string& app_dir_path, const AppTypeByDir& type_by_dir,
+                            const std::vector<std::string>& localization_dirs,
+                            std::map<std::string, std::string>& file_stats) const;
   void RegisterNewAppDesc(AppDescPtr new_desc, AppDescMaps& app_roster);
 
   AppDescriptionFactoryInterface* app_desc_factory_;
   AppScanFilterInterface* app_scan_filter_;
   ScanMode scan_mode_;
+  ScanMode pending_scan_mode_;
   std::vector<AppDir> target_dirs_;
+  std::vector<ScanTask> scan_tasks_;
+  GThread* scan_thread_;
   AppDescMaps app_desc_maps_;
+  AppScanCache scan_cache_;
+  Mutex localization_mutex_;
+  std::map<std::string, LocalizationEntry> localization_cache_;
   std::string language_;
   std::string script_;
   std::string region_;
+  bool has_pending_locale_;
+  std::string pending_language_;
+  std::string pending_script_;
+  std::string pending_region_;
 };
 
 #endif // CORE_PACKAGE_APP_SCANNER_H_
@@ -21,6 +21,7 @@
 #include <sys/stat.h>
 
 #include <cstring>
+#include <functional>
 #include <boost/algorithm/string.hpp>
 #include <boost/lexical_cast.hpp>
 #include <string>
@@ -50,7 +51,9 @@ ApplicationDescription::ApplicationDescription()
       lockable_ (true),
       splash_on_launch_ (true),
       spinner_on_launch_(false),
-      boot_params_(pbnjson::JValue()) {
+      boot_params_(pbnjson::JValue()),
+      content_hash_(0),
+      content_hash_valid_(false) {
   m_deviceId = pbnjson::Object();
   redirection_ = pbnjson::Object();
 }
@@ -62,6 +65,14 @@ std::string ApplicationDescription::toString() const {
   return JUtil::jsonToString(appinfo_json_);
 }
 
+std::size_t ApplicationDescription::ContentHash() const {
+  if (!content_hash_valid_) {
+    content_hash_ = std::hash<std::string>()(toString());
+    content_hash_valid_ = true;
+  }
+  return content_hash_;
+}
+
 const std::list<ResourceHandler>& ApplicationDescription::mimeTypes() const {
   return mime_types_;
 }
@@ -290,6 +301,7 @@ bool ApplicationDescription::LoadJson(pbnjson::JValue& jdesc, const AppTypeByDir
   if (!jdesc.hasKey("installTime")) jdesc.put("installTime", 0);
 
   appinfo_json_ = jdesc;
+  content_hash_valid_ = false;
   return true;
 }
 
@@ -590,5 +602,8 @@ bool ApplicationDescription::IsSame(AppDescPtr me, AppDescPtr another) {
   if (me->app_id_ != another->app_id_) return false;
   if (me->folder_path_ != another->folder_path_) return false;
   if (me->version_ != another->version_) return false;
-  return true;
+  // appinfo can be changed without version up (e.g. dev apps, localization).
+  // hash only rejects fast, equal hashes can still come from different appinfo
+  if (me->ContentHash() != another->ContentHash()) return false;
+  return me->toString() == another->toString();
 }
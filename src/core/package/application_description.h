@@ -109,13 +109,15 @@ class ApplicationDescription {
   const std::list<RedirectHandler>& redirectTypes() const;
   pbnjson::JValue toJValue() const { return appinfo_json_; }
   std::string toString() const;
+  std::size_t ContentHash() const;
 
   // setter
   void SetIntVersion(uint16_t major, uint16_t minor, uint16_t micro) { int_version_ = {major, minor, micro}; }
   void flagForRemoval(bool rf=true) { flagged_for_removal_ = rf;}
   void executionLock(bool xp=true) { is_locked_for_excution_ = xp;}
   void setLaunchParams(const pbnjson::JValue& launchParams) {
-    launch_params_ = launchParams.duplicate(); appinfo_json_.put("launchParams", launch_params_); }
+    launch_params_ = launchParams.duplicate(); appinfo_json_.put("launchParams", launch_params_);
+    content_hash_valid_ = false; }
   void setDeviceId (const pbnjson::JValue& deviceId) { m_deviceId = deviceId;}
 
   // feature functions
@@ -200,6 +202,8 @@ class ApplicationDescription {
   std::string     enyo_version_;
   pbnjson::JValue m_deviceId;
   pbnjson::JValue appinfo_json_;
+  mutable std::size_t content_hash_;  // hash of appinfo_json_, calculated on demand, reset whenever it's changed here
+  mutable bool    content_hash_valid_;
   KeywordMap      keywords_;
   std::list<ResourceHandler> mime_types_;
   std::list<RedirectHandler> redirect_types_;
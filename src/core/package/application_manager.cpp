@@ -116,8 +116,10 @@ namespace CallChainEventHandler {
   };
 }
 
-ApplicationManager::ApplicationManager() : first_full_scan_started_(false) {
+ApplicationManager::ApplicationManager() : first_full_scan_started_(false), roster_ready_(false) {
   app_scanner_.signalAppScanFinished.connect(boost::bind(&ApplicationManager::OnAppScanFinished, this, _1, _2));
+  app_dir_watcher_.signalAppDirChanged.connect(boost::bind(&ApplicationManager::OnAppDirChanged, this, _1));
+  app_dir_watcher_.signalEventOverflow.connect(boost::bind(&ApplicationManager::OnAppDirEventOverflow, this));
 }
 
 ApplicationManager::~ApplicationManager() {
@@ -159,6 +161,10 @@ void ApplicationManager::StartPostInit()
     app_scanner_.AddDirectory(it.first, it.second);
   }
 
+  if (SettingsImpl::instance().use_app_dir_watcher_) {
+    app_dir_watcher_.Start(base_dirs, SettingsImpl::instance().app_dir_watcher_debounce_ms_);
+  }
+
   Scan();
 }
 
@@ -229,14 +235,44 @@ void ApplicationManager::OnAppUninstalled(const std::string& app_id) {
   RemoveApp(app_id, true, AppStatusChangeEvent::APP_UNINSTALLED);
 }
 
+void ApplicationManager::OnAppDirChanged(const std::string& app_id) {
+
+  // check again after running scan is done, it might have read old files already
+  if (app_scanner_.isRunning()) {
+    apps_changed_on_scanning_.insert(app_id);
+    return;
+  }
+
+  ReconcileApp(app_id);
+}
+
+void ApplicationManager::ReconcileApp(const std::string& app_id) {
+
+  // package is being installed/updated, appinstalld status will reload it
+  if (!AppInfoManager::instance().can_execute(app_id)) {
+    LOG_INFO(MSGID_PACKAGE_STATUS, 2, PMLOGKS("app_id", app_id.c_str()), PMLOGKS("action", "reconcile"),
+                                      "locked for update, just skip");
+    return;
+  }
+
+  if (getAppById(app_id)) ReloadApp(app_id);
+  else OnAppInstalled(app_id);
+}
+
+void ApplicationManager::OnAppDirEventOverflow() {
+
+  Rescan(std::vector<std::string>{"app_dir_watcher"});
+}
+
 const AppDescMaps& ApplicationManager::allApps() {
   return app_roster_;
 }
 
 AppDescPtr ApplicationManager::getAppById(const std::string& app_id) {
 
-  if (app_roster_.count(app_id) == 0) return NULL;
-  return app_roster_[app_id];
+  auto it = app_roster_.find(app_id);
+  if (it == app_roster_.end()) return NULL;
+  return it->second;
 }
 
 void ApplicationManager::ReplaceAppDesc(const std::string& app_id, AppDescPtr new_desc) {
@@ -356,6 +392,9 @@ void ApplicationManager::ReloadApp(const std::string& app_id) {
 
   AppDescPtr rescanned_desc = app_scanner_.ScanForOneApp(app_id);
   if (!rescanned_desc) {
+    // same as removal found by full scan: running app is closed and its handlers are dropped
+    AppLifeManager::instance().close_apps(std::vector<std::string>{app_id}, true);
+    current_desc->clearMimeData();
     PublishOneAppChange(current_desc, APP_CHANGE_REMOVED, AppStatusChangeEvent::APP_UNINSTALLED);
     app_roster_.erase(app_id);
     AppInfoManager::instance().remove_app_info(app_id);
@@ -395,43 +434,123 @@ void ApplicationManager::OnLocaleChanged(
     const std::string& lang, const std::string& region, const std::string& script) {
 
   app_scanner_.SetBCP47Info(lang, region, script);
-  Rescan({"LANG"});
+
+  // roster is not loaded yet or being reloaded, so scanning will apply new locale
+  if (!first_full_scan_started_ || app_scanner_.isRunning()) {
+    Rescan({"LANG"});
+    return;
+  }
+
+  // only localization is changed, re-merge cached overlays instead of full scan
+  AppDescMaps changed_apps = app_scanner_.RelocalizeApps(app_roster_);
+  for (const auto& it : changed_apps) {
+    ReplaceAppDesc(it.first, it.second);
+  }
+
+  LOG_INFO(MSGID_START_SCAN, 2, PMLOGKS("STATUS", "RELOCALIZED"),
+                                PMLOGKFV("changed", "%d", (int) changed_apps.size()), "");
+
+  if (!changed_apps.empty()) signalAllAppRosterChanged(app_roster_);
+
+  scan_reason_.push_back("LANG");
+  PublishListApps();
+  scan_reason_.clear();
 }
 
 void ApplicationManager::OnAppScanFinished(ScanMode mode, const AppDescMaps& scanned_apps) {
 
   if (ScanMode::FULL_SCAN == mode) {
 
-    // check changes after rescan
+    // compare with current roster, then apply only changed apps
+    AppDescMaps added_apps;
+    AppDescMaps updated_apps;
+    std::vector<std::string> removed_apps;
+
     for (const auto& app: scanned_apps) {
-      if (app_roster_.count(app.first) == 0) {
+      auto current_it = app_roster_.find(app.first);
+      if (current_it == app_roster_.end()) {
         LOG_INFO(MSGID_PACKAGE_STATUS, 1, PMLOGKS("added_after_full_scan", app.first.c_str()), "");
-        signal_app_status_changed(AppStatusChangeEvent::APP_INSTALLED, app.second);
+        added_apps[app.first] = app.second;
+      } else if (!ApplicationDescription::IsSame(current_it->second, app.second)) {
+        updated_apps[app.first] = app.second;
       }
     }
-    std::vector<std::string> removed_apps;
     for (const auto& app: app_roster_) {
+      // changed while scanning, it's reconciled below
+      if (apps_changed_on_scanning_.count(app.first) > 0) continue;
       if (scanned_apps.count(app.first) == 0) {
         LOG_INFO(MSGID_PACKAGE_STATUS, 1, PMLOGKS("removed_after_full_scan", app.first.c_str()), "");
         removed_apps.push_back(app.first);
-        signal_app_status_changed(AppStatusChangeEvent::APP_UNINSTALLED, app.second);
       }
     }
 
+    LOG_INFO(MSGID_PACKAGE_STATUS, 3, PMLOGKFV("added", "%d", (int) added_apps.size()),
+                                      PMLOGKFV("updated", "%d", (int) updated_apps.size()),
+                                      PMLOGKFV("removed", "%d", (int) removed_apps.size()),
+                                      "full scan finished");
+
     // close removed apps if it's running
     if (!removed_apps.empty())
       AppLifeManager::instance().close_apps(removed_apps, true);
 
-    Clear();
-    app_roster_ = scanned_apps;
+    if (!roster_ready_) {
+      // first full scan: boot time apps were loaded without mime data, so build all
+      for (const auto& app_id : removed_apps) {
+        signal_app_status_changed(AppStatusChangeEvent::APP_UNINSTALLED, app_roster_[app_id]);
+      }
+      for (const auto& app: added_apps) {
+        signal_app_status_changed(AppStatusChangeEvent::APP_INSTALLED, app.second);
+      }
 
-    for (const auto& it: app_roster_) {
-      (it.second)->setMimeData();
-    }
+      MimeSystemImpl::instance().clearMimeTable();
+      app_roster_ = scanned_apps;
+      for (const auto& it: app_roster_) {
+        (it.second)->setMimeData();
+      }
+
+      roster_ready_ = true;
+      signalAllAppRosterChanged(app_roster_);
+      PublishListApps();
+    } else {
+      bool is_changed = !(added_apps.empty() && updated_apps.empty() && removed_apps.empty());
+
+      for (const auto& app_id : removed_apps) {
+        AppDescPtr current_desc = app_roster_[app_id];
+        current_desc->clearMimeData();
+        app_roster_.erase(app_id);
+        if (scan_reason_.empty())
+          PublishOneAppChange(current_desc, APP_CHANGE_REMOVED, AppStatusChangeEvent::APP_UNINSTALLED);
+        else
+          signal_app_status_changed(AppStatusChangeEvent::APP_UNINSTALLED, current_desc);
+      }
+      for (const auto& app: updated_apps) {
+        ReplaceAppDesc(app.first, app.second);
+        if (scan_reason_.empty())
+          PublishOneAppChange(app.second, APP_CHANGE_UPDATED, AppStatusChangeEvent::UPDATE_COMPLETED);
+      }
+      for (const auto& app: added_apps) {
+        app_roster_[app.first] = app.second;
+        app.second->setMimeData();
+        if (scan_reason_.empty())
+          PublishOneAppChange(app.second, APP_CHANGE_ADDED, AppStatusChangeEvent::APP_INSTALLED);
+        else
+          signal_app_status_changed(AppStatusChangeEvent::APP_INSTALLED, app.second);
+      }
 
-    signalAllAppRosterChanged(app_roster_);
-    PublishListApps();
+      if (is_changed) signalAllAppRosterChanged(app_roster_);
+      // patterns of removed handlers are compiled again only if an app brings them back
+      if (!removed_apps.empty() || !updated_apps.empty()) RedirectHandler::pruneRegexPool();
+      // clients requested rescan with reason get whole list as before
+      if (!scan_reason_.empty()) PublishListApps();
+    }
     scan_reason_.clear();
+
+    // apply package changes which scanning might have missed
+    std::set<std::string> changed_apps;
+    changed_apps.swap(apps_changed_on_scanning_);
+    for (const auto& app_id : changed_apps) {
+      ReconcileApp(app_id);
+    }
   } else if (ScanMode::PARTIAL_SCAN == mode) {
 
     for (auto& it : scanned_apps) {
@@ -570,6 +689,8 @@ bool ApplicationManager::cbAppUninstalled(LSHandle* lshandle, LSMessage *message
 
 void ApplicationManager::OnPackageStatusChanged(const std::string& app_id, const PackageStatus& status) {
 
+  if (app_scanner_.isRunning()) apps_changed_on_scanning_.insert(app_id);
+
   if (PackageStatus::Installed == status) OnAppInstalled(app_id);
   else if (PackageStatus::InstallFailed == status) ReloadApp(app_id);
   else if (PackageStatus::Uninstalled == status) OnAppUninstalled(app_id);
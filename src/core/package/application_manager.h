@@ -22,12 +22,14 @@
 #include <luna-service2/lunaservice.h>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
 #include "core/base/singleton.h"
 #include "core/lifecycle/application_errors.h"
 #include "core/module/subscriber_of_appinstalld.h"
+#include "core/package/app_dir_watcher.h"
 #include "core/package/app_scanner.h"
 #include "core/package/application_description.h"
 #include "interface/package/appscan_filter_interface.h"
@@ -57,6 +59,8 @@ class ApplicationManager : public Singleton<ApplicationManager> {
   AppDescPtr getAppById(const std::string& app_id);
   const AppDescMaps& allApps();
   AppScanner& appScanner() { return app_scanner_; }
+  // true once the first full scan is applied. after that, roster keeps serving during rescans
+  bool IsRosterReady() const { return roster_ready_; }
   bool LockAppForUpdate(const std::string& app_id, bool lock, std::string& err_text);
   void UninstallApp(const std::string& id, std::string& errorReason);
 
@@ -85,6 +89,7 @@ class ApplicationManager : public Singleton<ApplicationManager> {
                  AppStatusChangeEvent event = AppStatusChangeEvent::APP_UNINSTALLED);
   void ReloadApp(const std::string& app_id);
   void ReplaceAppDesc(const std::string& app_id, AppDescPtr new_desc);
+  void ReconcileApp(const std::string& app_id);
   void RemoveAppsOnUSB(const std::string& app_dir, const AppTypeByDir& app_type);
 
   void OnLocaleChanged(const std::string& lang, const std::string& region, const std::string& script);
@@ -94,6 +99,8 @@ class ApplicationManager : public Singleton<ApplicationManager> {
   void OnAppInstalled(const std::string& app_id);
   void OnAppUninstalled(const std::string& app_id);
   void OnAppScanFinished(ScanMode mode, const AppDescMaps& scanned_apps);
+  void OnAppDirChanged(const std::string& app_id);
+  void OnAppDirEventOverflow();
   void OnPackageStatusChanged(const std::string& app_id, const PackageStatus& status);
 
   void PublishListApps();
@@ -101,8 +108,11 @@ class ApplicationManager : public Singleton<ApplicationManager> {
 
   // variables
   AppScanner  app_scanner_;
+  AppDirWatcher app_dir_watcher_;
   AppDescMaps app_roster_;
   bool        first_full_scan_started_;
+  bool        roster_ready_;
+  std::set<std::string> apps_changed_on_scanning_;
   std::vector<std::string>  scan_reason_;
 };
 
@@ -19,12 +19,54 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
 #include <boost/regex.hpp>
 #include <string>
 
 #include "core/base/jutil.h"
+#include "core/base/mutex.h"
+#include "core/base/mutex_locker.h"
 #include "core/package/mime_system.h"
 
+/**
+ * Pool of compiled url regular expressions keyed by pattern and flags.
+ * Handlers are copied freely in and out of MimeSystem tables, so they share
+ * one compiled regex per distinct pattern instead of compiling on every copy.
+ * The pool keeps strong references, so clearing and rebuilding the tables (e.g. on first full scan)
+ * reuses compiled patterns. Unused ones are dropped only by RedirectHandler::pruneRegexPool().
+ */
+typedef std::map<std::pair<std::string,boost::regex::flag_type>,std::shared_ptr<const boost::regex> > RegexPoolType;
+static Mutex s_regexPoolMutex;
+static RegexPoolType s_regexPool;
+
+static std::shared_ptr<const boost::regex> acquireRegex(const std::string& pattern,boost::regex::flag_type flags = boost::regex::normal)
+{
+    MutexLocker lock(&s_regexPoolMutex);
+
+    std::pair<std::string,boost::regex::flag_type> key(pattern, flags);
+    RegexPoolType::iterator it = s_regexPool.find(key);
+    if (it != s_regexPool.end())
+        return it->second;
+
+    std::shared_ptr<const boost::regex> regex = std::make_shared<const boost::regex>(pattern, flags);
+    s_regexPool[key] = regex;
+    return regex;
+}
+
+//static
+void RedirectHandler::pruneRegexPool()
+{
+    MutexLocker lock(&s_regexPoolMutex);
+
+    //pool holds the only reference of patterns which are not used by any handler anymore
+    for (RegexPoolType::iterator it = s_regexPool.begin(); it != s_regexPool.end();) {
+        if (it->second.use_count() == 1)
+            s_regexPool.erase(it++);
+        else
+            ++it;
+    }
+}
+
 /**
  * Constructor.
  */
@@ -41,7 +83,7 @@ RedirectHandler::RedirectHandler(const std::string& urlRe, const std::string& ap
          m_index = MimeSystem::assignIndex();
     }
     if (!urlRe.empty()){
-        m_urlReg.set_expression(urlRe);
+        m_urlReg = acquireRegex(urlRe);
     }
 }
 
@@ -58,7 +100,7 @@ RedirectHandler::RedirectHandler(const std::string& urlRe, const std::string& ap
          m_index = MimeSystem::assignIndex();
     }
     if (!urlRe.empty()) {
-        m_urlReg.set_expression(urlRe);
+        m_urlReg = acquireRegex(urlRe);
     }
 }
 
@@ -71,10 +113,7 @@ RedirectHandler::RedirectHandler(const RedirectHandler& c)
     m_index = c.m_index;
     m_schemeForm = c.m_schemeForm;
     m_verbs = c.m_verbs;
-
-    if (!m_urlRe.empty()) {
-        m_urlReg.set_expression(m_urlRe);
-    }
+    m_urlReg = c.m_urlReg;
 }
 RedirectHandler& RedirectHandler::operator=(const RedirectHandler& c)
 {
@@ -88,10 +127,7 @@ RedirectHandler& RedirectHandler::operator=(const RedirectHandler& c)
     m_index = c.m_index;
     m_schemeForm = c.m_schemeForm;
     m_verbs = c.m_verbs;
-
-    if (!m_urlRe.empty()) {
-        m_urlReg.set_expression(m_urlRe);
-    }
+    m_urlReg = c.m_urlReg;
 
     return *this;
 }
@@ -113,7 +149,7 @@ RedirectHandler::~RedirectHandler()
  */
 bool RedirectHandler::matches(const std::string& url) const
 {
-    return !url.empty() && reValid() && boost::regex_match(url, m_urlReg);
+    return !url.empty() && reValid() && boost::regex_match(url, *m_urlReg);
 }
 
 /**
@@ -121,7 +157,7 @@ bool RedirectHandler::matches(const std::string& url) const
  */
 bool RedirectHandler::reValid() const
 {
-    return m_urlReg.status() == 0;
+    return m_urlReg && m_urlReg->status() == 0;
 }
 
 bool RedirectHandler::addVerb(const std::string& verb,const std::string& jsonizedParams)
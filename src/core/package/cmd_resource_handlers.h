@@ -20,6 +20,7 @@
 #include <stdint.h>
 
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -82,11 +83,14 @@ public:
 
     const std::map<std::string,std::string>& verbs() { return m_verbs;}
 
+    // drop compiled regexes of patterns which no handler uses anymore
+    static void pruneRegexPool();
+
 private:
 
     std::string m_urlRe; ///< The URL regular expression
     std::string m_appId;
-    boost::regex m_urlReg; ///< The compiled URL regular expression
+    std::shared_ptr<const boost::regex> m_urlReg; ///< The compiled URL regular expression, shared through the regex pool
     bool m_valid;
     bool m_schemeForm;
     std::string m_tag;
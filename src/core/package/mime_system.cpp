@@ -778,7 +778,8 @@ int MimeSystem::ResourceHandlerNode::fixupVerbCacheTable(const pbnjson::JValue&
  */
 int MimeSystem::populateFromJson(const pbnjson::JValue& root)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
 
     if (root.isNull())
         return 0;
@@ -874,7 +875,7 @@ int MimeSystem::populateFromJson(const pbnjson::JValue& root)
 
 std::string MimeSystem::getActiveAppIdForResource(std::string mimeType)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -887,7 +888,7 @@ std::string MimeSystem::getActiveAppIdForResource(std::string mimeType)
 
 int MimeSystem::getAllAppIdForResource(std::string mimeType,std::string& r_active,std::vector<std::string>& r_alternatives)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -908,20 +909,26 @@ int MimeSystem::getAllAppIdForResource(std::string mimeType,std::string& r_activ
 
 ResourceHandler MimeSystem::getActiveHandlerForResource(std::string mimeType)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
+    ResourceHandler handler;
+    if (m_resourceResolveCache.get(mimeType, m_tableGeneration, handler))
+        return handler;
+
     ResourceMapIterType it = m_resourceHandlerMap.find(mimeType);
     if (it != m_resourceHandlerMap.end()) {
-        return it->second->m_resourceHandler;
+        handler = it->second->m_resourceHandler;
     }
-    return ResourceHandler(); //return invalid object (see ResourceHandler::valid() )
+    //invalid object is cached as well (see ResourceHandler::valid() )
+    m_resourceResolveCache.put(mimeType, m_tableGeneration, handler);
+    return handler;
 }
 
 int MimeSystem::getAllHandlersForResource(std::string mimeType,ResourceHandler& r_active,std::vector<ResourceHandler>& r_alternatives)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -942,7 +949,7 @@ int MimeSystem::getAllHandlersForResource(std::string mimeType,ResourceHandler&
 
 std::string MimeSystem::getActiveAppIdForRedirect(const std::string& url,bool doNotUseRegexpMatch,bool disallowSchemeForms)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectMapIterType it;
 
     if (doNotUseRegexpMatch) {
@@ -954,7 +961,9 @@ std::string MimeSystem::getActiveAppIdForRedirect(const std::string& url,bool do
         }
     }
     else {
-        for (it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+        std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+        for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+            it = *cand_it;
             if ((disallowSchemeForms) && (it->second->m_redirectHandler.isSchemeForm()))
                 continue;
             //try and match against it
@@ -967,7 +976,7 @@ std::string MimeSystem::getActiveAppIdForRedirect(const std::string& url,bool do
 
 int MimeSystem::getAllAppIdForRedirect(const std::string& url,bool doNotUseRegexpMatch,std::string& r_active,std::vector<std::string>& r_alternatives)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     int rc=0;
     RedirectMapIterType it;
     if (doNotUseRegexpMatch) {
@@ -992,7 +1001,9 @@ int MimeSystem::getAllAppIdForRedirect(const std::string& url,bool doNotUseRegex
     }
 
     //else, do a regexp match
-    for (it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        it = *cand_it;
         //try and match against it
         if (it->second->m_redirectHandler.matches(url) == false)
             continue;
@@ -1023,32 +1034,43 @@ int MimeSystem::getAllAppIdForRedirect(const std::string& url,bool doNotUseRegex
 
 RedirectHandler MimeSystem::getActiveHandlerForRedirect(const std::string& url,bool doNotUseRegexpMatch, bool disallowSchemeForms)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectMapIterType it;
+    RedirectHandler handler;
+
+    //the same url can resolve differently depending on the lookup options
+    std::string cacheKey = std::string(doNotUseRegexpMatch ? "1" : "0") + (disallowSchemeForms ? "1" : "0") + url;
+    if (m_redirectResolveCache.get(cacheKey, m_tableGeneration, handler))
+        return handler;
 
     if (doNotUseRegexpMatch) {
         //strict retrieval by string equivalence on the regexp
         it = m_redirectHandlerMap.find(url);
         if (it != m_redirectHandlerMap.end()) {
             //found
-            return it->second->m_redirectHandler;
+            handler = it->second->m_redirectHandler;
         }
     }
     else {
-        for (it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+        std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+        for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+            it = *cand_it;
             if ((disallowSchemeForms) && (it->second->m_redirectHandler.isSchemeForm()))
                 continue;
             //try and match against it
-            if (it->second->m_redirectHandler.matches(url))
-                return it->second->m_redirectHandler;
+            if (it->second->m_redirectHandler.matches(url)) {
+                handler = it->second->m_redirectHandler;
+                break;
+            }
         }
     }
-    return RedirectHandler();
+    m_redirectResolveCache.put(cacheKey, m_tableGeneration, handler);
+    return handler;
 }
 
 int MimeSystem::getAllHandlersForRedirect(const std::string& url,bool doNotUseRegexpMatch,RedirectHandler& r_active,std::vector<RedirectHandler>& r_alternatives)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     int rc=0;
     RedirectMapIterType it;
     if (doNotUseRegexpMatch) {
@@ -1076,7 +1098,9 @@ int MimeSystem::getAllHandlersForRedirect(const std::string& url,bool doNotUseRe
 
     //else, do a regexp match
 
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         //try and match against it
         if (it->second->m_redirectHandler.matches(url) == false)
             continue;
@@ -1107,7 +1131,7 @@ int MimeSystem::getAllHandlersForRedirect(const std::string& url,bool doNotUseRe
 
 std::string MimeSystem::getAppIdByVerbForResource(std::string mimeType,const std::string& verb,std::string& r_params,uint32_t& r_index)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -1140,7 +1164,7 @@ std::string MimeSystem::getAppIdByVerbForResource(std::string mimeType,const std
 
 ResourceHandler MimeSystem::getHandlerByVerbForResource(std::string mimeType,const std::string& verb)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -1165,7 +1189,7 @@ ResourceHandler MimeSystem::getHandlerByVerbForResource(std::string mimeType,con
 
 int MimeSystem::getAllHandlersByVerbForResource(std::string mimeType,const std::string& verb,std::vector<ResourceHandler>& r_handlers)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -1208,7 +1232,7 @@ int MimeSystem::getAllHandlersByVerbForResource(std::string mimeType,const std::
 
 int MimeSystem::getAllAppIdByVerbForResource(std::string mimeType,const std::string& verb,std::vector<VerbInfo>& r_handlers)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -1249,9 +1273,11 @@ int MimeSystem::getAllAppIdByVerbForResource(std::string mimeType,const std::str
 
 std::string MimeSystem::getAppIdByVerbForRedirect(const std::string& url,bool disallowSchemeForms,const std::string& verb,std::string& r_params,uint32_t& r_index)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectHandlerNode * p_rhn = NULL;
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if ((disallowSchemeForms) && (it->second->m_redirectHandler.isSchemeForm()))
             continue;
         //try and match against it
@@ -1288,9 +1314,11 @@ std::string MimeSystem::getAppIdByVerbForRedirect(const std::string& url,bool di
 
 RedirectHandler MimeSystem::getHandlerByVerbForRedirect(const std::string& url,bool disallowSchemeForms,const std::string& verb)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectHandlerNode * p_rhn = NULL;
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if ((disallowSchemeForms) && (it->second->m_redirectHandler.isSchemeForm()))
             continue;
         //try and match against it
@@ -1321,10 +1349,12 @@ RedirectHandler MimeSystem::getHandlerByVerbForRedirect(const std::string& url,b
 
 int MimeSystem::getAllHandlersByVerbForRedirect(const std::string& url,const std::string& verb,std::vector<RedirectHandler>& r_handlers)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectHandlerNode * p_rhn = NULL;
     int rc = 0;
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if (it->second->m_redirectHandler.matches(url) == false)
             continue;
 
@@ -1363,10 +1393,12 @@ int MimeSystem::getAllHandlersByVerbForRedirect(const std::string& url,const std
 
 int MimeSystem::getAllAppIdByVerbForRedirect(const std::string& url,const std::string& verb,std::vector<VerbInfo>& r_handlers)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     RedirectHandlerNode * p_rhn = NULL;
     int rc = 0;
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if (it->second->m_redirectHandler.matches(url) == false)
             continue;
 
@@ -1428,12 +1460,22 @@ ResourceHandler MimeSystem::getResourceHandlerDirect(const uint32_t index)
 
 int MimeSystem::removeAllForAppId(const std::string& appId)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     std::vector<std::string> keys;
-    //go through all the nodes
+    //go through the nodes the app registered to, in map order (index reclaiming order matters for saved tables)
+    std::set<std::string> nodeKeys;
+    std::map<std::string,std::set<std::string> >::iterator app_it = m_redirectKeysByAppId.find(appId);
+    if (app_it != m_redirectKeysByAppId.end()) {
+        nodeKeys.swap(app_it->second);
+        m_redirectKeysByAppId.erase(app_it);
+    }
 
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it)
+    for (std::set<std::string>::iterator key_it = nodeKeys.begin();key_it != nodeKeys.end();++key_it)
     {
+        RedirectMapIterType it = m_redirectHandlerMap.find(*key_it);
+        if (it == m_redirectHandlerMap.end())
+            continue;
         int rc = it->second->removeAppId(appId);
         if (rc == RC_HANDLERNODE_REMOVEAPPID_REMOVENODE) {
             //need to remove the whole node
@@ -1447,12 +1489,22 @@ int MimeSystem::removeAllForAppId(const std::string& appId)
         MimeSystem::reclaimIndex(found_it->second->m_redirectHandler.index());
         delete (found_it->second);
         m_redirectHandlerMap.erase(*it);
+        unindexRedirectPattern(*it);
     }
     keys.clear();
     // and do the same for the Resources...
+    nodeKeys.clear();
+    app_it = m_resourceKeysByAppId.find(appId);
+    if (app_it != m_resourceKeysByAppId.end()) {
+        nodeKeys.swap(app_it->second);
+        m_resourceKeysByAppId.erase(app_it);
+    }
 
-    for (ResourceMapIterType it = m_resourceHandlerMap.begin();it != m_resourceHandlerMap.end();++it)
+    for (std::set<std::string>::iterator key_it = nodeKeys.begin();key_it != nodeKeys.end();++key_it)
     {
+        ResourceMapIterType it = m_resourceHandlerMap.find(*key_it);
+        if (it == m_resourceHandlerMap.end())
+            continue;
         int rc = it->second->removeAppId(appId);
         if (rc == RC_HANDLERNODE_REMOVEAPPID_REMOVENODE) {
             //need to remove the whole node
@@ -1473,7 +1525,8 @@ int MimeSystem::removeAllForAppId(const std::string& appId)
 
 int MimeSystem::removeAllForMimeType(std::string mimeType)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
 
     std::transform(mimeType.begin(), mimeType.end(), mimeType.begin(), tolower);
 
@@ -1481,6 +1534,7 @@ int MimeSystem::removeAllForMimeType(std::string mimeType)
     ResourceMapIterType it = m_resourceHandlerMap.find(mimeType);
     if (it == m_resourceHandlerMap.end())
         return 0;
+    indexAppIdsOfNode(mimeType, it->second, false);
     delete (it->second);
     m_resourceHandlerMap.erase(it);
     return 1;
@@ -1488,13 +1542,16 @@ int MimeSystem::removeAllForMimeType(std::string mimeType)
 
 int MimeSystem::removeAllForUrl(const std::string& url)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     //find the RedirectHandlerNode, and delete it
     RedirectMapIterType it = m_redirectHandlerMap.find(url);
     if (it == m_redirectHandlerMap.end())
         return 0;
+    indexAppIdsOfNode(url, it->second, false);
     delete (it->second);
     m_redirectHandlerMap.erase(it);
+    unindexRedirectPattern(url);
     return 1;
 }
 
@@ -1503,7 +1560,8 @@ int MimeSystem::removeAllForUrl(const std::string& url)
  */
 MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string& extension,std::string mimeType,bool shouldDownload,const std::string appId,const std::map<std::string,std::string> * pVerbs,bool sysDefault)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
 
     //if mimeType is blank, fail
     if (mimeType.size() == 0)
@@ -1518,22 +1576,18 @@ MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string& extension,std:
         std::transform(extension.begin(), extension.end(), extension.begin(), tolower);
 
     //check to see if the mime<->extension mapping already exists
-    std::map<std::string,std::string>::iterator mit = m_extensionToMimeMap.find(extension);
-    if (mit == m_extensionToMimeMap.end()) {
+    if (m_mimeByExtension.find(extension) == m_mimeByExtension.end()) {
         //add it...
-        m_extensionToMimeMap[extension] = mimeType;
+        mapExtension(extension,mimeType);
     }
     else {
 
         //( if it already exists, just ignore the redefinition)
         //...but replace the extension passed in with the found one, so that the caller knows his extension proposal was rejected and a different one used
-        for (mit = m_extensionToMimeMap.begin();mit != m_extensionToMimeMap.end();++mit)
-        {
-            if (mit->second == mimeType) {
-                extension = mit->first;
-                break;
-            }
-        }
+        //(the first one in extension order, as the extension map is ordered by extension)
+        std::unordered_map<std::string,std::set<std::string> >::iterator eit = m_extensionsByMime.find(mimeType);
+        if (eit != m_extensionsByMime.end() && !eit->second.empty())
+            extension = *(eit->second.begin());
     }
     //see if there is a primary entry already
     ResourceMapIterType it = m_resourceHandlerMap.find(mimeType);
@@ -1545,6 +1599,7 @@ MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string& extension,std:
             p_rhn->m_resourceHandler.setTag("system-default"); //also tag as a system default
         }
         m_resourceHandlerMap[mimeType] = p_rhn;
+        m_resourceKeysByAppId[appId].insert(mimeType);
         return Mime_PrimaryEntry;
     }
 
@@ -1565,16 +1620,18 @@ MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string& extension,std:
     else{
         p_rhn->m_alternates.push_back(p_newHandler);
     }
+    m_resourceKeysByAppId[appId].insert(mimeType);
     return Mime_Ok;
 }
 
 MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string extension,bool shouldDownload,const std::string appId,const std::map<std::string,std::string> * pVerbs,bool sysDefault)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     //find the mime type for this extension
     std::transform(extension.begin(), extension.end(), extension.begin(), tolower);
-    std::map<std::string,std::string>::iterator mit = m_extensionToMimeMap.find(extension);
-    if (mit == m_extensionToMimeMap.end()) {
+    std::unordered_map<std::string,std::string>::iterator mit = m_mimeByExtension.find(extension);
+    if (mit == m_mimeByExtension.end()) {
         //doesn't exist... fail
         return Mime_Error;
     }
@@ -1588,6 +1645,7 @@ MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string extension,bool
         if (sysDefault)
             p_rhn->m_resourceHandler.setTag("system-default"); //also tag as a system default
         m_resourceHandlerMap[mimeType] = p_rhn;
+        m_resourceKeysByAppId[appId].insert(mimeType);
         return Mime_PrimaryEntry;
     }
 
@@ -1601,13 +1659,15 @@ MimeSystem::ErrorType MimeSystem::addResourceHandler(std::string extension,bool
     p_rhn->m_handlersByIndex[p_newHandler->index()] = p_newHandler;
 
     p_rhn->m_alternates.push_back(p_newHandler);
+    m_resourceKeysByAppId[appId].insert(mimeType);
 
     return Mime_Ok;
 }
 
 MimeSystem::ErrorType MimeSystem::addRedirectHandler(const std::string& url,const std::string appId,const std::map<std::string,std::string> * pVerbs,bool isSchemeForm,bool sysDefault)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     //see if there is a primary entry already
     RedirectMapIterType it = m_redirectHandlerMap.find(url);
     if (it == m_redirectHandlerMap.end()) {
@@ -1616,6 +1676,8 @@ MimeSystem::ErrorType MimeSystem::addRedirectHandler(const std::string& url,cons
         if (sysDefault)
             p_rhn->m_redirectHandler.setTag("system-default"); //also tag as a system default
         m_redirectHandlerMap[url] = p_rhn;
+        indexRedirectPattern(url);
+        m_redirectKeysByAppId[appId].insert(url);
         return Mime_PrimaryEntry;
     }
 
@@ -1629,11 +1691,14 @@ MimeSystem::ErrorType MimeSystem::addRedirectHandler(const std::string& url,cons
     p_rhn->m_handlersByIndex[p_newHandler->index()] = p_newHandler;
 
     p_rhn->m_alternates.push_back(p_newHandler);
+    m_redirectKeysByAppId[appId].insert(url);
     return Mime_Ok;
 }
 
 int MimeSystem::addVerbsToResourceHandler(std::string mimeType,const std::string& appId,const std::map<std::string,std::string>& verbs)
 {
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
 
     std::transform(mimeType.begin(),mimeType.end(),mimeType.begin(),tolower);
     ResourceMapIterType resource_it = m_resourceHandlerMap.find(mimeType);
@@ -1655,6 +1720,8 @@ int MimeSystem::addVerbsToResourceHandler(std::string mimeType,const std::string
 
 int MimeSystem::addVerbsToRedirectHandler(const std::string& url,const std::string& appId,const std::map<std::string,std::string>& verbs)
 {
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     RedirectMapIterType redirect_it = m_redirectHandlerMap.find(url);
     if (redirect_it != m_redirectHandlerMap.end())
     {
@@ -1674,6 +1741,8 @@ int MimeSystem::addVerbsToRedirectHandler(const std::string& url,const std::stri
 
 int MimeSystem::addVerbsDirect(uint32_t index,const std::map<std::string,std::string>& verbs)
 {
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     //scan all the maps to find one that has the index in question
     for (ResourceMapIterType resource_it = m_resourceHandlerMap.begin();
          resource_it != m_resourceHandlerMap.end();++resource_it)
@@ -1696,7 +1765,8 @@ int MimeSystem::addVerbsDirect(uint32_t index,const std::map<std::string,std::st
 
 bool MimeSystem::swapResourceHandler(std::string mimeType, uint32_t index)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     std::transform(mimeType.begin(),mimeType.end(),mimeType.begin(),tolower);
 
     ResourceMapIterType it = m_resourceHandlerMap.find(mimeType);
@@ -1708,7 +1778,8 @@ bool MimeSystem::swapResourceHandler(std::string mimeType, uint32_t index)
 
 bool MimeSystem::swapRedirectHandler(const std::string& url, uint32_t index)
 {
-    MutexLocker lock(&m_mutex);
+    WriteLocker lock(&m_tableLock);
+    tableChanged();
     RedirectMapIterType it = m_redirectHandlerMap.find(url);
     if (it == m_redirectHandlerMap.end())
         return false;
@@ -1718,14 +1789,24 @@ bool MimeSystem::swapRedirectHandler(const std::string& url, uint32_t index)
 
 bool MimeSystem::getMimeTypeByExtension(std::string extension,std::string& r_mimeType)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     std::transform(extension.begin(), extension.end(), extension.begin(), tolower);
-    std::map<std::string,std::string>::iterator it = m_extensionToMimeMap.find(extension);
-    if (it != m_extensionToMimeMap.end()) {
-        r_mimeType = it->second;
-        return true;
-    }
-    return false;
+
+    std::unordered_map<std::string,std::string>::iterator it = m_mimeByExtension.find(extension);
+    if (it == m_mimeByExtension.end())
+        return false;
+    r_mimeType = it->second;
+    return true;
+}
+
+pbnjson::JValue MimeSystem::resolveCacheStatsAsJson()
+{
+    ReadLocker lock(&m_tableLock);
+    pbnjson::JValue jobj = pbnjson::Object();
+    jobj.put("generation", (int64_t)m_tableGeneration);
+    jobj.put("redirect", m_redirectResolveCache.statsAsJson());
+    jobj.put("resource", m_resourceResolveCache.statsAsJson());
+    return jobj;
 }
 
 //static
@@ -1759,7 +1840,7 @@ std::string MimeSystem::makePseudoExtensionFromMime(const std::string& mimeType)
 
 std::string MimeSystem::allTablesAsJsonString()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Object();
     jobj.put("resources", resourceTableAsJsonArray());
     jobj.put("redirects",redirectTableAsJsonArray());
@@ -1768,14 +1849,14 @@ std::string MimeSystem::allTablesAsJsonString()
 
 std::string MimeSystem::resourceTableAsJsonString()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = resourceTableAsJson();
     return JUtil::jsonToString(jobj);
 }
 
 pbnjson::JValue  MimeSystem::resourceTableAsJson()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Object();
     pbnjson::JValue jarray = pbnjson::Array();
 
@@ -1793,7 +1874,7 @@ pbnjson::JValue  MimeSystem::resourceTableAsJson()
 
 pbnjson::JValue MimeSystem::resourceTableAsJsonArray()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Array();
 
     for (ResourceMapIterType it = m_resourceHandlerMap.begin();
@@ -1810,14 +1891,14 @@ pbnjson::JValue MimeSystem::resourceTableAsJsonArray()
 
 std::string MimeSystem::redirectTableAsJsonString()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = redirectTableAsJson();
     return JUtil::jsonToString(jobj);
 }
 
 pbnjson::JValue MimeSystem::redirectTableAsJson()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Object();
     pbnjson::JValue jarray = pbnjson::Array();
 
@@ -1835,7 +1916,7 @@ pbnjson::JValue MimeSystem::redirectTableAsJson()
 
 pbnjson::JValue MimeSystem::redirectTableAsJsonArray()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Array();
     for (RedirectMapIterType it = m_redirectHandlerMap.begin();
          it != m_redirectHandlerMap.end();++it)
@@ -1850,14 +1931,14 @@ pbnjson::JValue MimeSystem::redirectTableAsJsonArray()
 
 std::string MimeSystem::extensionMapAsJsonString()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = extensionMapAsJson();
     return JUtil::jsonToString(jobj);
 }
 
 pbnjson::JValue MimeSystem::extensionMapAsJson()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jobj = pbnjson::Object();
     pbnjson::JValue jarr = pbnjson::Array();
 
@@ -1873,7 +1954,7 @@ pbnjson::JValue MimeSystem::extensionMapAsJson()
 
 pbnjson::JValue MimeSystem::extensionMapAsJsonArray()
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     pbnjson::JValue jarr = pbnjson::Array();
 
     for (std::map<std::string,std::string>::iterator it = m_extensionToMimeMap.begin();
@@ -1905,64 +1986,28 @@ std::string MimeSystem::mimeTableAsString(std::string& r_err)
 
 bool MimeSystem::saveMimeTable(const std::string& file,std::string& r_err)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
+    //saving doesn't change the tables, but the file mustn't be written concurrently
+    MutexLocker save_lock(&m_saveMutex);
     r_err.clear();
-    //try and open the file
-    FILE * fp = fopen(file.c_str(),"w");
-    if (!fp) {
-        r_err = "Unable to open file "+file;
-        return false;
-    }
 
     std::string s = mimeTableAsString(r_err);
-
-    if(r_err.empty()) {
-        //write it
-        size_t wr = fwrite(s.data(),1,s.size(),fp);
-        if (wr != s.size()) {
-            r_err = "Couldn't write maps to file "+file;
-        }
-        else {
-            fprintf(fp,"\n\n");
-        }
-    }
-
-    fclose(fp);
     if (r_err.size())
         return false;
 
+    //restore at boot reads this file, so it's replaced at once or not at all
+    if (!writeFileAtomically(file,s+"\n\n")) {
+        r_err = "Couldn't write maps to file "+file;
+        return false;
+    }
+
     return true;
 }
 
 bool MimeSystem::saveMimeTableToActiveFile(std::string& r_err)
 {
-    MutexLocker locker(&m_mutex);
-    r_err.clear();
-    //try and open the file
-    FILE * fp = fopen(SettingsImpl::instance().lunaCmdHandlerSavedPath.c_str(),"w");
-    if (!fp) {
-        r_err = std::string("Unable to open file ")+SettingsImpl::instance().lunaCmdHandlerSavedPath;
-        return false;
-    }
-
-    std::string s = mimeTableAsString(r_err);
-
-    if(r_err.empty()) {
-        //write it
-        size_t wr = fwrite(s.data(),1,s.size(),fp);
-        if (wr != s.size()) {
-            r_err = std::string("Couldn't write maps to file ")+SettingsImpl::instance().lunaCmdHandlerSavedPath;
-        }
-        else {
-            fprintf(fp,"\n\n");
-        }
-    }
-
-    fclose(fp);
-    if (r_err.size())
-        return false;
-
-    return true;
+    (void) makeDir(SettingsImpl::instance().appMgrPreferenceDir);
+    return saveMimeTable(SettingsImpl::instance().lunaCmdHandlerSavedPath,r_err);
 }
 
 bool MimeSystem::restoreMimeTable(const std::string& file,std::string& r_err)
@@ -1975,10 +2020,14 @@ bool MimeSystem::restoreMimeTable(const std::string& file,std::string& r_err)
         return false;
     }
 
-    pbnjson::JValue root(tables);
-    bool rc = restoreMimeTable(root,r_err);
+    pbnjson::JValue root = JUtil::parse(tables.c_str(),"");
+    if (root.isNull() || !root["schemaVersion"].isNumber() ||
+        root["schemaVersion"].asNumber<int32_t>() != s_json_schema_version) {
+        r_err = "Saved tables of other version in "+file;
+        return false;
+    }
 
-    return rc;
+    return restoreMimeTable(root,r_err);
 }
 
 bool MimeSystem::restoreMimeTable(const pbnjson::JValue& root,std::string& r_err)
@@ -1986,13 +2035,15 @@ bool MimeSystem::restoreMimeTable(const pbnjson::JValue& root,std::string& r_err
     std::string val_s;
     pbnjson::JValue topLevel_jobj;
 
+    WriteLocker lock(&m_tableLock);
+
     if (root.isNull()) {
         r_err = "Invalid json";
         goto Done_restoreMimeTable;
     }
 
-    //restore the extension map
-    m_extensionToMimeMap.clear();
+    //saved tables replace the current ones, handlers registered so far must not stay mixed in
+    destroyTables();
 
     if(root.hasKey("extensionMap")) {
         topLevel_jobj = root["extensionMap"];
@@ -2006,7 +2057,7 @@ bool MimeSystem::restoreMimeTable(const pbnjson::JValue& root,std::string& r_err
                         r_err = "Can't process 'extensionMap'";
                         return false;
                     }
-                    m_extensionToMimeMap[pIt.first.asString()] = val_s;
+                    mapExtension(pIt.first.asString(),val_s);
                 }
             }
         }
@@ -2030,6 +2081,8 @@ bool MimeSystem::restoreMimeTable(const pbnjson::JValue& root,std::string& r_err
                 if (p_rhn != NULL) {
                     //add...
                     m_redirectHandlerMap[p_rhn->m_redirectHandler.urlRe()] = p_rhn;
+                    indexRedirectPattern(p_rhn->m_redirectHandler.urlRe());
+                    indexAppIdsOfNode(p_rhn->m_redirectHandler.urlRe(), p_rhn, true);
                 }
             }
         }
@@ -2052,6 +2105,7 @@ bool MimeSystem::restoreMimeTable(const pbnjson::JValue& root,std::string& r_err
                 if (p_rhn != NULL) {
                     //add...
                     m_resourceHandlerMap[p_rhn->m_resourceHandler.contentType()] = p_rhn;
+                    indexAppIdsOfNode(p_rhn->m_resourceHandler.contentType(), p_rhn, true);
                 }
             }
         }
@@ -2116,7 +2170,7 @@ bool MimeSystem::dbg_printMimeTables()
 
 bool MimeSystem::dbg_getResourceTableStrings(std::vector<std::pair<std::string,std::vector<std::string> > >& r_resourceTableStrings)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     for (ResourceMapIterType it = m_resourceHandlerMap.begin();
          it != m_resourceHandlerMap.end();++it)
     {
@@ -2135,7 +2189,7 @@ bool MimeSystem::dbg_getResourceTableStrings(std::vector<std::pair<std::string,s
 
 bool MimeSystem::dbg_getRedirectTableStrings(std::vector<std::pair<std::string,std::vector<std::string> > >& r_redirectTableStrings)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     for (RedirectMapIterType it = m_redirectHandlerMap.begin();
          it != m_redirectHandlerMap.end();++it)
     {
@@ -2154,7 +2208,7 @@ bool MimeSystem::dbg_getRedirectTableStrings(std::vector<std::pair<std::string,s
 
 void MimeSystem::dbg_printVerbCacheTableForResource(const std::string& mime)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     ResourceHandlerNode * p_rhn = getResourceHandlerNode(mime);
     if (p_rhn == NULL) {
         printf("didn't find any nodes for mime type %s\n",mime.c_str());
@@ -2166,7 +2220,7 @@ void MimeSystem::dbg_printVerbCacheTableForResource(const std::string& mime)
 
 void MimeSystem::dbg_printVerbCacheTableForRedirect(const std::string& url)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     RedirectHandlerNode * p_rhn = this->getRedirectHandlerNode(url);
     if (p_rhn == NULL) {
         printf("didn't find any nodes for redirect(url) %s\n",url.c_str());
@@ -2177,7 +2231,7 @@ void MimeSystem::dbg_printVerbCacheTableForRedirect(const std::string& url)
 
 void MimeSystem::dbg_printVerbCacheTableForScheme(const std::string& url)
 {
-    MutexLocker locker(&m_mutex);
+    ReadLocker locker(&m_tableLock);
     RedirectHandlerNode * p_rhn = this->getSchemeHandlerNode(url);
     if (p_rhn == NULL) {
         printf("didn't find any nodes for redirect(scheme) %s\n",url.c_str());
@@ -2217,8 +2271,11 @@ void MimeSystem::dbg_printRedirectHandlerNode(const RedirectHandlerNode * p_redi
 // ---------------------------------------------------------------------------------------------------------------------
 
 MimeSystem::MimeSystem()
+    : m_tableGeneration(0)
 {
-
+    size_t capacity = SettingsImpl::instance().mime_resolve_cache_size_;
+    m_redirectResolveCache.setCapacity(capacity);
+    m_resourceResolveCache.setCapacity(capacity);
 }
 
 //virtual
@@ -2229,14 +2286,24 @@ MimeSystem::~MimeSystem()
 
 void MimeSystem::destroy()
 {
-    MutexLocker locker(&m_mutex);
-    m_extensionToMimeMap.clear();
+    WriteLocker locker(&m_tableLock);
+    destroyTables();
+}
+
+void MimeSystem::destroyTables()
+{
+    tableChanged();
+    clearExtensionMap();
     for (RedirectMapIterType it = m_redirectHandlerMap.begin();
          it != m_redirectHandlerMap.end();++it)
     {
         delete it->second;
     }
     m_redirectHandlerMap.clear();
+    m_redirectIndexByScheme.clear();
+    m_redirectIndexAnyScheme = RedirectIndexBucket();
+    m_redirectIndexResidual.clear();
+    m_redirectKeysByAppId.clear();
 
     for (ResourceMapIterType it = m_resourceHandlerMap.begin();
          it != m_resourceHandlerMap.end();++it)
@@ -2244,6 +2311,7 @@ void MimeSystem::destroy()
         delete it->second;
     }
     m_resourceHandlerMap.clear();
+    m_resourceKeysByAppId.clear();
 
     MutexLocker lock_index(&s_mutex);
     s_indexRecycler.clear();
@@ -2395,7 +2463,7 @@ int MimeSystem::extractVerbsFromHandlerNodeEntryJson(const pbnjson::JValue& json
 
 MimeSystem::ResourceHandlerNode * MimeSystem::getResourceHandlerNode(const std::string& mimeType)
 {
-    MutexLocker lock(&m_mutex);
+    ReadLocker lock(&m_tableLock);
     ResourceMapIterType it = m_resourceHandlerMap.find(mimeType);
     if (it != m_resourceHandlerMap.end()) {
         return it->second;
@@ -2406,8 +2474,10 @@ MimeSystem::ResourceHandlerNode * MimeSystem::getResourceHandlerNode(const std::
 
 MimeSystem::RedirectHandlerNode * MimeSystem::getRedirectHandlerNode(const std::string& url)
 {
-    MutexLocker lock(&m_mutex);
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    ReadLocker lock(&m_tableLock);
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if (it->second->m_redirectHandler.isSchemeForm())
             continue;
         //try and match against it
@@ -2420,8 +2490,10 @@ MimeSystem::RedirectHandlerNode * MimeSystem::getRedirectHandlerNode(const std::
 
 MimeSystem::RedirectHandlerNode * MimeSystem::getSchemeHandlerNode(const std::string& url)
 {
-    MutexLocker lock(&m_mutex);
-    for (RedirectMapIterType it = m_redirectHandlerMap.begin();it != m_redirectHandlerMap.end();++it) {
+    ReadLocker lock(&m_tableLock);
+    std::vector<RedirectMapIterType> candidates = getRedirectCandidates(url);
+    for (std::vector<RedirectMapIterType>::iterator cand_it = candidates.begin();cand_it != candidates.end();++cand_it) {
+        RedirectMapIterType it = *cand_it;
         if (it->second->m_redirectHandler.isSchemeForm() == false)
             continue;
         //try and match against it
@@ -2431,3 +2503,222 @@ MimeSystem::RedirectHandlerNode * MimeSystem::getSchemeHandlerNode(const std::st
     return NULL;
 }
 
+// Literal text which every url matched by the pattern has to start with.
+// regex_match anchors the whole url, so a leading '^' doesn't change anything.
+// Returns empty string when the beginning of the pattern is not literal.
+static std::string extractLiteralPrefix(const std::string& urlRe, size_t pos)
+{
+    static const std::string metaChars = ".[](){}*+?^$|";
+    static const std::string quantifiers = "?*+{";
+    std::string prefix;
+
+    while (pos < urlRe.size()) {
+        char c = urlRe[pos];
+        size_t len = 1;
+        if (c == '\\') {
+            // escaped punctuation is literal, but \d, \w, \1... are not
+            if (pos + 1 >= urlRe.size() || isalnum((unsigned char)urlRe[pos+1]))
+                break;
+            c = urlRe[pos+1];
+            len = 2;
+        }
+        else if (metaChars.find(c) != std::string::npos) {
+            break;
+        }
+        // the char is optional or repeated, so it can't be a part of the prefix
+        if (pos + len < urlRe.size() && quantifiers.find(urlRe[pos+len]) != std::string::npos)
+            break;
+        prefix += c;
+        pos += len;
+    }
+    return prefix;
+}
+
+// Split the pattern into scheme and host prefix index keys.
+// Returns false if the pattern can't be indexed and has to be always evaluated.
+static bool parseRedirectPattern(const std::string& urlRe,bool& r_anyScheme,std::string& r_scheme,std::string& r_hostPrefix)
+{
+    // alternation can make any part of the pattern optional
+    if (urlRe.find('|') != std::string::npos)
+        return false;
+
+    size_t pos = (!urlRe.empty() && urlRe[0] == '^') ? 1 : 0;
+    std::string prefix;
+
+    // "[^:]+://" is used for patterns to accept any scheme
+    if (urlRe.compare(pos, 8, "[^:]+://") == 0 || urlRe.compare(pos, 8, "[^:]*://") == 0) {
+        r_anyScheme = true;
+        r_scheme.clear();
+        prefix = "://" + extractLiteralPrefix(urlRe, pos + 8);
+    }
+    else {
+        r_anyScheme = false;
+        prefix = extractLiteralPrefix(urlRe, pos);
+        size_t colon = prefix.find(':');
+        if (colon == std::string::npos)
+            return false;
+        r_scheme = prefix.substr(0, colon);
+        prefix = prefix.substr(colon);
+    }
+
+    r_hostPrefix.clear();
+    if (prefix.compare(0, 3, "://") == 0)
+        r_hostPrefix = prefix.substr(3, prefix.find('/', 3) - 3);
+    return true;
+}
+
+void MimeSystem::indexRedirectPattern(const std::string& urlRe)
+{
+    bool anyScheme;
+    std::string scheme, hostPrefix;
+
+    if (!parseRedirectPattern(urlRe, anyScheme, scheme, hostPrefix)) {
+        m_redirectIndexResidual.insert(urlRe);
+        return;
+    }
+
+    RedirectIndexBucket& bucket = anyScheme ? m_redirectIndexAnyScheme : m_redirectIndexByScheme[scheme];
+    if (hostPrefix.empty())
+        bucket.m_patterns.insert(urlRe);
+    else
+        bucket.m_patternsByHost[hostPrefix].insert(urlRe);
+}
+
+void MimeSystem::unindexRedirectPattern(const std::string& urlRe)
+{
+    bool anyScheme;
+    std::string scheme, hostPrefix;
+
+    if (!parseRedirectPattern(urlRe, anyScheme, scheme, hostPrefix)) {
+        m_redirectIndexResidual.erase(urlRe);
+        return;
+    }
+
+    std::map<std::string,RedirectIndexBucket>::iterator scheme_it = m_redirectIndexByScheme.end();
+    if (!anyScheme) {
+        scheme_it = m_redirectIndexByScheme.find(scheme);
+        if (scheme_it == m_redirectIndexByScheme.end())
+            return;
+    }
+
+    RedirectIndexBucket& bucket = anyScheme ? m_redirectIndexAnyScheme : scheme_it->second;
+    if (hostPrefix.empty()) {
+        bucket.m_patterns.erase(urlRe);
+    }
+    else {
+        std::map<std::string,std::set<std::string> >::iterator host_it = bucket.m_patternsByHost.find(hostPrefix);
+        if (host_it != bucket.m_patternsByHost.end()) {
+            host_it->second.erase(urlRe);
+            if (host_it->second.empty())
+                bucket.m_patternsByHost.erase(host_it);
+        }
+    }
+
+    if (!anyScheme && bucket.m_patterns.empty() && bucket.m_patternsByHost.empty())
+        m_redirectIndexByScheme.erase(scheme_it);
+}
+
+void MimeSystem::mapExtension(const std::string& extension,const std::string& mimeType)
+{
+    std::unordered_map<std::string,std::string>::iterator it = m_mimeByExtension.find(extension);
+    if (it != m_mimeByExtension.end()) {
+        if (it->second == mimeType)
+            return;
+        std::unordered_map<std::string,std::set<std::string> >::iterator eit = m_extensionsByMime.find(it->second);
+        if (eit != m_extensionsByMime.end()) {
+            eit->second.erase(extension);
+            if (eit->second.empty())
+                m_extensionsByMime.erase(eit);
+        }
+    }
+    m_extensionToMimeMap[extension] = mimeType;
+    m_mimeByExtension[extension] = mimeType;
+    m_extensionsByMime[mimeType].insert(extension);
+}
+
+void MimeSystem::clearExtensionMap()
+{
+    m_extensionToMimeMap.clear();
+    m_mimeByExtension.clear();
+    m_extensionsByMime.clear();
+}
+
+void MimeSystem::indexAppIdsOfNode(const std::string& url,RedirectHandlerNode * p_rhn,bool add)
+{
+    std::vector<std::string> appIds;
+    appIds.push_back(p_rhn->m_redirectHandler.appId());
+    for (std::vector<RedirectHandler *>::iterator it = p_rhn->m_alternates.begin();it != p_rhn->m_alternates.end();++it)
+        appIds.push_back((*it)->appId());
+    indexAppIds(m_redirectKeysByAppId, url, appIds, add);
+}
+
+void MimeSystem::indexAppIdsOfNode(const std::string& mimeType,ResourceHandlerNode * p_rhn,bool add)
+{
+    std::vector<std::string> appIds;
+    appIds.push_back(p_rhn->m_resourceHandler.appId());
+    for (auto it = p_rhn->m_alternates.begin();it != p_rhn->m_alternates.end();++it)
+        appIds.push_back((*it)->appId());
+    indexAppIds(m_resourceKeysByAppId, mimeType, appIds, add);
+}
+
+//static
+void MimeSystem::indexAppIds(std::map<std::string,std::set<std::string> >& index,const std::string& key,const std::vector<std::string>& appIds,bool add)
+{
+    for (std::vector<std::string>::const_iterator it = appIds.begin();it != appIds.end();++it) {
+        if (add) {
+            index[*it].insert(key);
+            continue;
+        }
+        std::map<std::string,std::set<std::string> >::iterator app_it = index.find(*it);
+        if (app_it == index.end())
+            continue;
+        app_it->second.erase(key);
+        if (app_it->second.empty())
+            index.erase(app_it);
+    }
+}
+
+void MimeSystem::collectRedirectCandidates(const RedirectIndexBucket& bucket,const std::string& host,std::set<std::string>& r_patterns) const
+{
+    r_patterns.insert(bucket.m_patterns.begin(), bucket.m_patterns.end());
+    if (bucket.m_patternsByHost.empty())
+        return;
+
+    // host prefix keys don't have '/', so only the leading part of host can match
+    for (size_t len = 1; len <= host.size(); ++len) {
+        std::map<std::string,std::set<std::string> >::const_iterator host_it = bucket.m_patternsByHost.find(host.substr(0, len));
+        if (host_it != bucket.m_patternsByHost.end())
+            r_patterns.insert(host_it->second.begin(), host_it->second.end());
+    }
+}
+
+/*
+ * returns nodes whose pattern can match the url, in the same (key) order as m_redirectHandlerMap,
+ * so that callers picking the first match get the same node as when scanning the whole map
+ */
+std::vector<MimeSystem::RedirectMapIterType> MimeSystem::getRedirectCandidates(const std::string& url)
+{
+    std::set<std::string> patterns(m_redirectIndexResidual);
+
+    size_t colon = url.find(':');
+    if (colon != std::string::npos) {
+        std::string host;
+        if (url.compare(colon, 3, "://") == 0)
+            host = url.substr(colon + 3, url.find('/', colon + 3) - (colon + 3));
+
+        std::map<std::string,RedirectIndexBucket>::const_iterator scheme_it = m_redirectIndexByScheme.find(url.substr(0, colon));
+        if (scheme_it != m_redirectIndexByScheme.end())
+            collectRedirectCandidates(scheme_it->second, host, patterns);
+        collectRedirectCandidates(m_redirectIndexAnyScheme, host, patterns);
+    }
+
+    std::vector<RedirectMapIterType> candidates;
+    candidates.reserve(patterns.size());
+    for (std::set<std::string>::const_iterator it = patterns.begin();it != patterns.end();++it) {
+        RedirectMapIterType node_it = m_redirectHandlerMap.find(*it);
+        if (node_it != m_redirectHandlerMap.end())
+            candidates.push_back(node_it);
+    }
+    return candidates;
+}
+
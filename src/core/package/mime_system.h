@@ -18,14 +18,17 @@
 #define MIMESYSTEM_H_
 
 #include <algorithm>
+#include <list>
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <pbnjson.hpp>
 
 #include "core/base/mutex.h"
+#include "core/base/mutex_locker.h"
 #include "core/base/singleton.h"
 #include "core/package/cmd_resource_handlers.h"
 
@@ -142,6 +145,8 @@ public:
     bool clearMimeTable();
     static void deleteSavedMimeTable();
 
+    pbnjson::JValue resolveCacheStatsAsJson();
+
     //some utils
     static int extractVerbsFromHandlerEntryJson(const pbnjson::JValue& jsonHandlerEntry,std::map<std::string,std::string>& r_verbs);
     static int extractVerbsFromHandlerNodeEntryJson(const pbnjson::JValue &jsonHandlerNodeEntry, std::map<std::string,uint32_t>& r_verbs);
@@ -152,6 +157,7 @@ protected:
     MimeSystem& operator=(const MimeSystem& c) { return *this;}
     virtual ~MimeSystem();
     void destroy();
+    void destroyTables();  //caller holds m_tableLock for writing
 
     int populateFromJson(const pbnjson::JValue &jobj); //useful only for the initial command-resource-handlers.json file reading
 
@@ -307,12 +313,20 @@ protected:
     /// ------------------------------------------- vars -------------------------------------------------------------------
 
     static Mutex  s_mutex;
-    Mutex  m_mutex;
+    // queries take it for reading, so they run concurrently and only wait for table changes
+    RWLock  m_tableLock;
+    Mutex  m_saveMutex;
 
     std::map<std::string,MimeSystem::ResourceHandlerNode *> m_resourceHandlerMap;
     std::map<std::string,MimeSystem::RedirectHandlerNode *> m_redirectHandlerMap;
 
+    // extension -> mime type. Ordered one is what gets saved and listed,
+    // hashed ones serve the lookups in both directions. Change them only through mapExtension/clearExtensionMap.
     std::map<std::string,std::string> m_extensionToMimeMap;
+    std::unordered_map<std::string,std::string> m_mimeByExtension;
+    std::unordered_map<std::string,std::set<std::string> > m_extensionsByMime;   //sorted, so the first one matches extension map order
+    void mapExtension(const std::string& extension,const std::string& mimeType);
+    void clearExtensionMap();
     static uint32_t  s_genIndex;
     static uint32_t s_lastAssignedIndex;
     static std::vector<uint32_t> s_indexRecycler;
@@ -323,6 +337,108 @@ protected:
     typedef std::map<std::string,MimeSystem::RedirectHandlerNode *>::iterator RedirectMapIterType;
     typedef std::map<std::string,MimeSystem::VerbCacheEntry> VerbCacheMapType;
     typedef std::map<std::string,MimeSystem::VerbCacheEntry>::iterator VerbCacheMapIterType;
+
+    // index of redirect patterns by literal scheme and host prefix,
+    // so that url lookup evaluates only the regexps which can match
+    struct RedirectIndexBucket {
+        std::set<std::string> m_patterns;                                   //no literal host prefix
+        std::map<std::string,std::set<std::string> > m_patternsByHost;      //host prefix -> patterns
+    };
+
+    void indexRedirectPattern(const std::string& urlRe);
+    void unindexRedirectPattern(const std::string& urlRe);
+    void collectRedirectCandidates(const RedirectIndexBucket& bucket,const std::string& host,std::set<std::string>& r_patterns) const;
+    std::vector<RedirectMapIterType> getRedirectCandidates(const std::string& url);
+
+    // bounded LRU of resolved lookups. Entries are dropped as a whole
+    // when the generation they were stored with is not current anymore.
+    // Lookups update it under read lock of the tables, so it has its own mutex.
+    template <typename T>
+    class ResolveCache {
+    public:
+        ResolveCache() : m_capacity(0), m_generation(0), m_hits(0), m_misses(0) {}
+
+        void setCapacity(size_t capacity) { MutexLocker lock(&m_mutex); m_capacity = capacity; clear(); }
+
+        bool get(const std::string& key,uint32_t generation,T& r_value) {
+            MutexLocker lock(&m_mutex);
+            if (generation != m_generation) {
+                clear();
+                m_generation = generation;
+            }
+            typename IndexType::iterator it = m_index.find(key);
+            if (it == m_index.end()) {
+                ++m_misses;
+                return false;
+            }
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            r_value = it->second->second;
+            ++m_hits;
+            return true;
+        }
+
+        void put(const std::string& key,uint32_t generation,const T& value) {
+            MutexLocker lock(&m_mutex);
+            if (m_capacity == 0 || generation != m_generation)
+                return;
+            typename IndexType::iterator it = m_index.find(key);
+            if (it != m_index.end()) {
+                it->second->second = value;
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return;
+            }
+            m_entries.push_front(std::make_pair(key, value));
+            m_index[key] = m_entries.begin();
+            while (m_entries.size() > m_capacity) {
+                m_index.erase(m_entries.back().first);
+                m_entries.pop_back();
+            }
+        }
+
+        void clear() { m_entries.clear(); m_index.clear(); }
+
+        pbnjson::JValue statsAsJson() const {
+            MutexLocker lock(&m_mutex);
+            pbnjson::JValue jobj = pbnjson::Object();
+            jobj.put("size", (int64_t)m_entries.size());
+            jobj.put("capacity", (int64_t)m_capacity);
+            jobj.put("hits", (int64_t)m_hits);
+            jobj.put("misses", (int64_t)m_misses);
+            return jobj;
+        }
+
+    private:
+        typedef std::list<std::pair<std::string,T> > EntryListType;     //most recently used first
+        typedef std::map<std::string,typename EntryListType::iterator> IndexType;
+
+        mutable Mutex m_mutex;
+        EntryListType m_entries;
+        IndexType m_index;
+        size_t m_capacity;
+        uint32_t m_generation;
+        uint64_t m_hits;
+        uint64_t m_misses;
+    };
+
+    // every change of handler tables has to bump the generation to invalidate resolve caches
+    void tableChanged() { ++m_tableGeneration; }
+
+    uint32_t m_tableGeneration;
+    ResolveCache<RedirectHandler> m_redirectResolveCache;
+    ResolveCache<ResourceHandler> m_resourceResolveCache;
+
+    // app id -> keys of the nodes the app has a handler in, so that removeAllForAppId
+    // visits only those nodes
+    void indexAppIdsOfNode(const std::string& url,RedirectHandlerNode * p_rhn,bool add);
+    void indexAppIdsOfNode(const std::string& mimeType,ResourceHandlerNode * p_rhn,bool add);
+    static void indexAppIds(std::map<std::string,std::set<std::string> >& index,const std::string& key,const std::vector<std::string>& appIds,bool add);
+
+    std::map<std::string,std::set<std::string> > m_redirectKeysByAppId;
+    std::map<std::string,std::set<std::string> > m_resourceKeysByAppId;
+
+    std::map<std::string,RedirectIndexBucket> m_redirectIndexByScheme;
+    RedirectIndexBucket m_redirectIndexAnyScheme;                           //"[^:]+://..." patterns
+    std::set<std::string> m_redirectIndexResidual;                          //patterns without literal scheme
 };
 
 typedef Singleton<MimeSystem> MimeSystemImpl;
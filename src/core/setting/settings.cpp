@@ -50,13 +50,32 @@ Settings::Settings()
       launch_expired_timeout_(120000000000ULL), // 120sec
       loading_expired_timeout_(30000000000ULL), // 30sec
       last_loading_app_timeout_(30000), // 30sec
+      launch_coalesce_window_ms_(0),
+      use_native_app_cgroup_(false),
+      native_app_cgroup_root_("/sys/fs/cgroup/sam-native-apps"),
+      use_posix_spawn_(false),
+      use_launch_zygote_(false),
+      use_memory_reclaim_(false),
+      memory_reclaim_target_kb_(131072),
+      memory_reclaim_max_apps_(3),
+      use_criu_checkpoint_(false),
+      criu_checkpoint_ready_state_("background"),
+      criu_checkpoint_delay_ms_(2000),
+      criu_image_base_path_(kCriuImageBasePath),
       appInstallBase( kAppInstallBase ),
       appInstallRelative( "usr/palm/applications" ),
       devAppsBasePath( "/media/developer/apps" ),
       tempAliasAppBasePath( "/tmp/alias/apps" ),
       aliasAppBasePath( "/media/alias/apps" ),
       m_deletedSystemApps(pbnjson::Object()),
-      usePartialKeywordAppSearch( true ) {
+      usePartialKeywordAppSearch( true ),
+      app_scan_worker_num_(4),
+      use_app_scan_cache_(true),
+      app_scan_cache_path_(kAppScanCachePath),
+      use_app_dir_watcher_(false),
+      app_dir_watcher_debounce_ms_(500),
+      mime_resolve_cache_size_(128),
+      lunaCmdHandlerSavedPath(kMimeTableSavedPath) {
 }
 
 Settings::~Settings() {
@@ -185,6 +204,7 @@ bool Settings::LoadStaticConfig(const char* filePath) {
 
   if (root["ApplicationPaths"].isArray()) {
     pbnjson::JValue applicationPaths = root["ApplicationPaths"];
+    app_paths_conf_ = JUtil::jsonToString(applicationPaths);
     int arraySize = applicationPaths.arraySize();
 
     for (int i = 0; i < arraySize ; i++) {
@@ -227,6 +247,77 @@ bool Settings::LoadStaticConfig(const char* filePath) {
     usePartialKeywordAppSearch = root["UsePartialKeywordMatchForAppSearch"].asBool();
   }
 
+  if (root["AppScanWorkerNum"].isNumber()) {
+    int worker_num = root["AppScanWorkerNum"].asNumber<int>();
+    app_scan_worker_num_ = (worker_num > 0) ? (unsigned int) worker_num : 1;
+  }
+
+  if (root["UseAppScanCache"].isBoolean()) {
+    use_app_scan_cache_ = root["UseAppScanCache"].asBool();
+  }
+
+  if (root["UseAppDirWatcher"].isBoolean()) {
+    use_app_dir_watcher_ = root["UseAppDirWatcher"].asBool();
+  }
+
+  if (root["AppDirWatcherDebounceMs"].isNumber()) {
+    int debounce_ms = root["AppDirWatcherDebounceMs"].asNumber<int>();
+    app_dir_watcher_debounce_ms_ = (debounce_ms > 0) ? (unsigned int) debounce_ms : 0;
+  }
+
+  if (root["LaunchCoalesceWindowMs"].isNumber()) {
+    int window_ms = root["LaunchCoalesceWindowMs"].asNumber<int>();
+    launch_coalesce_window_ms_ = (window_ms > 0) ? (unsigned int) window_ms : 0;
+  }
+
+  if (root["UseNativeAppCgroup"].isBoolean()) {
+    use_native_app_cgroup_ = root["UseNativeAppCgroup"].asBool();
+  }
+
+  if (root["NativeAppCgroupRoot"].isString()) {
+    native_app_cgroup_root_ = root["NativeAppCgroupRoot"].asString();
+  }
+
+  if (root["UsePosixSpawn"].isBoolean()) {
+    use_posix_spawn_ = root["UsePosixSpawn"].asBool();
+  }
+
+  if (root["UseLaunchZygote"].isBoolean()) {
+    use_launch_zygote_ = root["UseLaunchZygote"].asBool();
+  }
+
+  if (root["UseMemoryReclaim"].isBoolean()) {
+    use_memory_reclaim_ = root["UseMemoryReclaim"].asBool();
+  }
+
+  if (root["MemoryReclaimTargetKB"].isNumber()) {
+    int target_kb = root["MemoryReclaimTargetKB"].asNumber<int>();
+    memory_reclaim_target_kb_ = (target_kb > 0) ? (unsigned int) target_kb : 0;
+  }
+
+  if (root["MemoryReclaimMaxApps"].isNumber()) {
+    int max_apps = root["MemoryReclaimMaxApps"].asNumber<int>();
+    memory_reclaim_max_apps_ = (max_apps > 0) ? (unsigned int) max_apps : 1;
+  }
+
+  if (root["UseCRIUCheckpoint"].isBoolean()) {
+    use_criu_checkpoint_ = root["UseCRIUCheckpoint"].asBool();
+  }
+
+  if (root["CRIUCheckpointReadyState"].isString()) {
+    criu_checkpoint_ready_state_ = root["CRIUCheckpointReadyState"].asString();
+  }
+
+  if (root["CRIUCheckpointDelayMs"].isNumber()) {
+    int delay_ms = root["CRIUCheckpointDelayMs"].asNumber<int>();
+    criu_checkpoint_delay_ms_ = (delay_ms > 0) ? (unsigned int) delay_ms : 0;
+  }
+
+  if (root["MimeResolveCacheSize"].isNumber()) {
+    int cache_size = root["MimeResolveCacheSize"].asNumber<int>();
+    mime_resolve_cache_size_ = (cache_size > 0) ? (unsigned int) cache_size : 0;
+  }
+
   if (root.hasKey("FullscreenWindowType") && root["FullscreenWindowType"].isArray()) {
     int array_size = root["FullscreenWindowType"].arraySize();
     for (int i = 0 ; i < array_size ; ++i) {
@@ -96,6 +96,18 @@ class Settings {
   unsigned long long int    launch_expired_timeout_;
   unsigned long long int    loading_expired_timeout_;
   guint                     last_loading_app_timeout_;
+  unsigned int              launch_coalesce_window_ms_;
+  bool                      use_native_app_cgroup_;
+  std::string               native_app_cgroup_root_; // /sys/fs/cgroup/sam-native-apps
+  bool                      use_posix_spawn_;
+  bool                      use_launch_zygote_;
+  bool                      use_memory_reclaim_;
+  unsigned int              memory_reclaim_target_kb_;
+  unsigned int              memory_reclaim_max_apps_;
+  bool                      use_criu_checkpoint_;
+  std::string               criu_checkpoint_ready_state_; // foreground or background
+  unsigned int              criu_checkpoint_delay_ms_;
+  std::string               criu_image_base_path_; // /var/lib/sam/criu
 
   // package related
   std::string               appInstallBase;       // /media/cryptofs/apps
@@ -107,8 +119,15 @@ class Settings {
   std::vector<std::string>  m_assetFallbackPrecedence;
   std::string               package_asset_variant_;
   bool                      usePartialKeywordAppSearch;
+  unsigned int              app_scan_worker_num_;
+  bool                      use_app_scan_cache_;
+  std::string               app_scan_cache_path_; // /var/preferences/com.webos.applicationManager/appScanCache.json
+  std::string               app_paths_conf_;      // ApplicationPaths in sam-conf.json as string
+  bool                      use_app_dir_watcher_;
+  unsigned int              app_dir_watcher_debounce_ms_;
+  unsigned int              mime_resolve_cache_size_;
   std::vector<std::string>  reservedMimes;
-  std::string               lunaCmdHandlerSavedPath;  // TODO: make it deprecated or restructured
+  std::string               lunaCmdHandlerSavedPath;  // /var/preferences/com.webos.applicationManager/mimeTable.json
 
 private:
   friend class Singleton<Settings>;
@@ -23,6 +23,7 @@
 #include "core/launch_point/launch_point_manager.h"
 #include "core/lifecycle/app_info.h"
 #include "core/lifecycle/app_life_manager.h"
+#include "core/lifecycle/memory_reclaimer.h"
 #include "core/module/service_observer.h"
 #include "core/module/subscriber_of_appinstalld.h"
 #include "core/module/subscriber_of_bootd.h"
@@ -52,6 +53,7 @@ void BaseExtension::init(PrerequisiteMonitor& prerequisite_monitor) {
   AppLifeManager::instance().set_prelauncher_handler(prelauncher_);
   AppLifeManager::instance().set_memory_checker_handler(memory_checker_);
   AppLifeManager::instance().set_lastapp_handler(lastapp_handler_);
+  MemoryReclaimer::instance().SetMeminfoPath(BaseSettingsImpl::instance().meminfo_path_);
 
   // set extension handlers for package interface
   ApplicationManager::instance().SetAppScanFilter(app_scan_filter_);
@@ -23,6 +23,7 @@
 #define MSGID_LAUNCH_LASTINPUT_ERR              "LAUNCH_LASTINPUT_ERR" /** error about launching last input app */
 #define MSGID_APPSCAN_FILTER_TV                 "APPSCAN_FILTER_TV"
 #define MSGID_CLEAR_FIRST_LAUNCHING_APP         "CLEAR_FIRST_LAUNCHNIG_APP" /** cancel launching first app on foreground app change */
+#define MSGID_MEMORY_ADMISSION                  "MEMORY_ADMISSION" /** memory check before launching */
 
 /* package */
 #define MSGID_PER_APP_SETTINGS                  "PER_APP_SETTINGS" /** per app settings feature */
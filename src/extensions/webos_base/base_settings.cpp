@@ -16,13 +16,23 @@
 
 #include "extensions/webos_base/base_settings.h"
 
+#include <algorithm>
+
 #include "core/base/jutil.h"
 #include "core/setting/settings.h"
 #include "core/setting/settings_conf.h"
 #include "extensions/webos_base/base_logs.h"
 #include "extensions/webos_base/base_settings_conf.h"
 
-BaseSettings::BaseSettings() {
+BaseSettings::BaseSettings()
+    : use_memory_admission_(false),
+      meminfo_path_("/proc/meminfo"),
+      memory_pressure_path_("/proc/pressure/memory"),
+      min_available_memory_kb_(65536),
+      max_memory_pressure_(40.0),
+      default_app_footprint_kb_(51200),
+      memory_admission_retry_ms_(500),
+      memory_admission_max_wait_ms_(3000) {
   launch_point_dbkind_ = pbnjson::Object();
   launch_point_permissions_ = pbnjson::Object();
 }
@@ -68,6 +78,35 @@ bool BaseSettings::LoadSAMConf(const char* file_path) {
   if (root.hasKey("LaunchPointDBPermissions"))
     launch_point_permissions_ = root["LaunchPointDBPermissions"];
 
+  if (root.hasKey("MemoryAdmission") && root["MemoryAdmission"].isObject()) {
+    pbnjson::JValue admission = root["MemoryAdmission"];
+
+    if (admission["enable"].isBoolean())
+      use_memory_admission_ = admission["enable"].asBool();
+    if (admission["meminfoPath"].isString())
+      meminfo_path_ = admission["meminfoPath"].asString();
+    if (admission["pressurePath"].isString())
+      memory_pressure_path_ = admission["pressurePath"].asString();
+    if (admission["minAvailableKB"].isNumber())
+      min_available_memory_kb_ = (unsigned int) std::max(0, admission["minAvailableKB"].asNumber<int>());
+    if (admission["maxPressureAvg10"].isNumber())
+      max_memory_pressure_ = admission["maxPressureAvg10"].asNumber<double>();
+    if (admission["defaultFootprintKB"].isNumber())
+      default_app_footprint_kb_ = (unsigned int) std::max(0, admission["defaultFootprintKB"].asNumber<int>());
+    if (admission["retryIntervalMs"].isNumber())
+      memory_admission_retry_ms_ = (unsigned int) std::max(1, admission["retryIntervalMs"].asNumber<int>());
+    if (admission["maxWaitMs"].isNumber())
+      memory_admission_max_wait_ms_ = (unsigned int) std::max(0, admission["maxWaitMs"].asNumber<int>());
+
+    if (admission["footprints"].isObject()) {
+      for (auto it : admission["footprints"].children()) {
+        if (!it.first.isString() || !it.second.isNumber())
+          continue;
+        app_footprints_kb_[it.first.asString()] = (unsigned int) std::max(0, it.second.asNumber<int>());
+      }
+    }
+  }
+
   return true;
 }
 
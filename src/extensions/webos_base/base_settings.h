@@ -32,6 +32,17 @@ public:
   pbnjson::JValue launch_point_dbkind_;
   pbnjson::JValue launch_point_permissions_;
 
+  // memory admission before launching
+  bool use_memory_admission_;
+  std::string meminfo_path_;                  // /proc/meminfo
+  std::string memory_pressure_path_;          // /proc/pressure/memory
+  unsigned int min_available_memory_kb_;      // MemAvailable to be left after launch
+  double max_memory_pressure_;                // "some avg10" of PSI
+  unsigned int default_app_footprint_kb_;
+  std::map<std::string, unsigned int> app_footprints_kb_;
+  unsigned int memory_admission_retry_ms_;
+  unsigned int memory_admission_max_wait_ms_;
+
 private:
   friend class Singleton<BaseSettings>;
   BaseSettings();
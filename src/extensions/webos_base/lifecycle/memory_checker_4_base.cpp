@@ -16,13 +16,20 @@
 
 #include "extensions/webos_base/lifecycle/memory_checker_4_base.h"
 
+#include <stdio.h>
+
+#include <fstream>
+
+#include "core/base/utils.h"
 #include "extensions/webos_base/base_logs.h"
+#include "extensions/webos_base/base_settings.h"
 
-MemoryChecker4Base::MemoryChecker4Base() {
+MemoryChecker4Base::MemoryChecker4Base() : retry_timer_(0) {
 
 }
 
 MemoryChecker4Base::~MemoryChecker4Base() {
+  stop_retry_timer();
 }
 
 void MemoryChecker4Base::add_item(AppLaunchingItemPtr item) {
@@ -61,21 +68,134 @@ void MemoryChecker4Base::remove_item(const std::string& item_uid) {
       [&item_uid](AppLaunchingItemPtr it) {return (it->uid() == item_uid);});
   if (it != app_launching_item_list_.end())
     app_launching_item_list_.erase(it);
+
+  delayed_since_.erase(item_uid);
 }
 
 void MemoryChecker4Base::run() {
+  stop_retry_timer();
+
   while (!app_launching_item_list_.empty()) {
-    auto it = app_launching_item_list_.begin();
+    AppLaunchingItem4BasePtr item = app_launching_item_list_.front();
+
+    // items are admitted in request order, so following items wait together
+    if (check_admission(item) == Admission::DELAY) {
+      retry_timer_ = g_timeout_add(BaseSettingsImpl::instance().memory_admission_retry_ms_,
+                                   MemoryChecker4Base::on_retry_timeout, (gpointer) this);
+      return;
+    }
+
+    finish_item(item);
+  }
+}
+
+MemoryChecker4Base::Admission MemoryChecker4Base::check_admission(AppLaunchingItem4BasePtr item) {
+  const BaseSettings& settings = BaseSettingsImpl::instance();
+  if (!settings.use_memory_admission_)
+    return Admission::ADMIT;
+
+  uint64_t available_kb = 0;
+  if (!read_mem_available(settings.meminfo_path_, available_kb)) {
+    LOG_WARNING(MSGID_MEMORY_ADMISSION, 2,
+                PMLOGKS("status", "no_meminfo"),
+                PMLOGKS("path", settings.meminfo_path_.c_str()), "admit without checking");
+    return Admission::ADMIT;
+  }
+
+  uint64_t footprint_kb = settings.default_app_footprint_kb_;
+  auto footprint = settings.app_footprints_kb_.find(item->app_id());
+  if (footprint != settings.app_footprints_kb_.end())
+    footprint_kb = footprint->second;
+  uint64_t required_kb = footprint_kb + settings.min_available_memory_kb_;
+
+  // PSI is optional, kernel can be built without it
+  double pressure = 0.0;
+  bool has_pressure = read_pressure_avg10(settings.memory_pressure_path_, pressure);
+
+  auto delayed = delayed_since_.find(item->uid());
+  if (available_kb >= required_kb && (!has_pressure || pressure <= settings.max_memory_pressure_)) {
+    if (delayed != delayed_since_.end()) {
+      LOG_INFO(MSGID_MEMORY_ADMISSION, 4,
+               PMLOGKS("app_id", item->app_id().c_str()),
+               PMLOGKS("status", "admitted_after_delay"),
+               PMLOGKFV("available_kb", "%llu", (unsigned long long) available_kb),
+               PMLOGKFV("waited_ms", "%.0f", (get_current_time() - delayed->second) / 1000000.0), "");
+    }
+    return Admission::ADMIT;
+  }
+
+  double now = get_current_time();
+  if (delayed == delayed_since_.end()) {
+    delayed_since_[item->uid()] = now;
+
+    LOG_INFO(MSGID_MEMORY_ADMISSION, 5,
+             PMLOGKS("app_id", item->app_id().c_str()),
+             PMLOGKS("status", "delay_launch"),
+             PMLOGKFV("available_kb", "%llu", (unsigned long long) available_kb),
+             PMLOGKFV("required_kb", "%llu", (unsigned long long) required_kb),
+             PMLOGKFV("pressure_avg10", "%.2f", pressure), "");
+
+    // under pressure without shortage, at least footprint of new app is reclaimed
+    uint64_t shortage_kb = (available_kb < required_kb) ? (required_kb - available_kb) : footprint_kb;
+    signal_memory_reclaim_required(item->app_id(), shortage_kb);
+    return Admission::DELAY;
+  }
+
+  // launching is never blocked for good, kernel decides after this
+  if (now - delayed->second >= settings.memory_admission_max_wait_ms_ * 1000000.0) {
+    LOG_WARNING(MSGID_MEMORY_ADMISSION, 4,
+                PMLOGKS("app_id", item->app_id().c_str()),
+                PMLOGKS("status", "admit_on_timeout"),
+                PMLOGKFV("available_kb", "%llu", (unsigned long long) available_kb),
+                PMLOGKFV("required_kb", "%llu", (unsigned long long) required_kb), "");
+    return Admission::ADMIT;
+  }
+
+  return Admission::DELAY;
+}
+
+void MemoryChecker4Base::finish_item(AppLaunchingItem4BasePtr item) {
+  item->set_sub_stage(static_cast<int>(AppLaunchingStage4Base::MEMORY_CHECK_DONE));
+
+  std::string uid = item->uid();
+  signal_memory_checking_done(uid);
+  remove_item(uid);
+}
+
+void MemoryChecker4Base::stop_retry_timer() {
+  if (retry_timer_ == 0)
+    return;
+
+  g_source_remove(retry_timer_);
+  retry_timer_ = 0;
+}
+
+gboolean MemoryChecker4Base::on_retry_timeout(gpointer user_data) {
+  MemoryChecker4Base* checker = static_cast<MemoryChecker4Base*>(user_data);
+  checker->retry_timer_ = 0;
+  checker->run();
+  return FALSE;
+}
 
-    (*it)->set_sub_stage(static_cast<int>(AppLaunchingStage4Base::MEMORY_CHECK_DONE));
+bool MemoryChecker4Base::read_pressure_avg10(const std::string& pressure_path, double& r_avg10) {
+  std::ifstream pressure(pressure_path.c_str());
+  if (!pressure.is_open())
+    return false;
 
-    std::string uid = (*it)->uid();
-    signal_memory_checking_done((*it)->uid());
-    remove_item(uid);
+  // some avg10=0.00 avg60=0.00 avg300=0.00 total=0
+  std::string line;
+  while (std::getline(pressure, line)) {
+    double avg10 = 0.0;
+    if (sscanf(line.c_str(), "some avg10=%lf", &avg10) == 1) {
+      r_avg10 = avg10;
+      return true;
+    }
   }
+  return false;
 }
 
 void MemoryChecker4Base::cancel_all() {
+  stop_retry_timer();
   for (auto& launching_item : app_launching_item_list_) {
     LOG_INFO(MSGID_APPLAUNCH, 2,
              PMLOGKS("app_id", launching_item->app_id().c_str()),
@@ -85,4 +205,5 @@ void MemoryChecker4Base::cancel_all() {
   }
 
   app_launching_item_list_.clear();
+  delayed_since_.clear();
 }
@@ -17,6 +17,11 @@
 #ifndef MEMORY_CHECKER_4_BASE_H
 #define MEMORY_CHECKER_4_BASE_H
 
+#include <glib.h>
+#include <stdint.h>
+
+#include <map>
+
 #include "extensions/webos_base/lifecycle/app_launching_item_4_base.h"
 #include "interface/lifecycle/memory_checker_interface.h"
 
@@ -30,8 +35,20 @@ public:
   virtual void run();
   virtual void cancel_all();
 
+  // path is given separately so that fixture file can be used instead of /proc
+  static bool read_pressure_avg10(const std::string& pressure_path, double& r_avg10);
+
 private:
+  enum class Admission { ADMIT, DELAY };
+
+  Admission check_admission(AppLaunchingItem4BasePtr item);
+  void finish_item(AppLaunchingItem4BasePtr item);
+  void stop_retry_timer();
+  static gboolean on_retry_timeout(gpointer user_data);
+
   AppLaunchingItem4BaseList app_launching_item_list_;
+  std::map<std::string, double> delayed_since_;  // uid -> time when first delayed
+  guint retry_timer_;
 
 };
 
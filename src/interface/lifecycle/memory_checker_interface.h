@@ -35,6 +35,8 @@ public:
 public:
     boost::signals2::signal<void (const std::string& uid)> signal_memory_checking_start;
     boost::signals2::signal<void (const std::string& uid)> signal_memory_checking_done;
+    // free memory is not enough for launching app, background apps should be reclaimed
+    boost::signals2::signal<void (const std::string& app_id, uint64_t required_kb)> signal_memory_reclaim_required;
 
 };
 
@@ -0,0 +1,117 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Regression check of foreground extra info events.
+// A recorded sequence of LSM foregroundAppInfo messages is fed to
+// AppLifeManager, and each signal_foreground_extra_info_changed is compared
+// with the rule AppLifeManager used before the single pass diff: filter the
+// message, then emit when the previous filtered array != the new one.
+//
+// usage: foreground_sequence_check sequence.json
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <unordered_set>
+
+#include "core/base/jutil.h"
+#include "core/lifecycle/app_info_manager.h"
+#include "core/lifecycle/app_life_manager.h"
+#include "core/module/subscriber_of_lsm.h"
+#include "core/setting/settings.h"
+
+static int s_events = 0;
+static pbnjson::JValue s_last_event;
+
+static void OnForegroundExtraInfoChanged(const pbnjson::JValue& foreground_info) {
+  ++s_events;
+  s_last_event = foreground_info.duplicate();
+}
+
+// filtering of on_foreground_info_changed: valid message, non-empty app id, running app
+static bool FilterByBaseline(const pbnjson::JValue& jmsg, const std::unordered_set<std::string>& running,
+                             pbnjson::JValue& filtered) {
+
+  if (!jmsg["returnValue"].asBool() || !jmsg["foregroundAppInfo"].isArray())
+    return false;
+
+  filtered = pbnjson::Array();
+  pbnjson::JValue lsm_foreground_info = jmsg["foregroundAppInfo"];
+  for (int i = 0; i < lsm_foreground_info.arraySize(); ++i) {
+    std::string app_id;
+    if (!lsm_foreground_info[i]["appId"].isString() ||
+        lsm_foreground_info[i]["appId"].asString(app_id) != CONV_OK ||
+        app_id.empty() || running.count(app_id) == 0)
+      continue;
+    filtered.append(lsm_foreground_info[i].duplicate());
+  }
+  return true;
+}
+
+int main(int argc, char** argv) {
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s sequence.json\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  pbnjson::JValue sequence = JUtil::parseFile(argv[1], "");
+  if (!sequence.isObject() || !sequence["running"].isArray() || !sequence["messages"].isArray()) {
+    fprintf(stderr, "invalid sequence file: %s\n", argv[1]);
+    return EXIT_FAILURE;
+  }
+
+  SettingsImpl::instance().fullscreen_window_types.push_back("_WEBOS_WINDOW_TYPE_CARD");
+  AppLifeManager::instance().init();
+  AppLifeManager::instance().signal_foreground_extra_info_changed.connect(OnForegroundExtraInfoChanged);
+
+  std::unordered_set<std::string> running;
+  for (int i = 0; i < sequence["running"].arraySize(); ++i) {
+    std::string app_id = sequence["running"][i].asString();
+    running.insert(app_id);
+    AppInfoManager::instance().set_life_status(app_id, LifeStatus::BACKGROUND);
+  }
+
+  int failures = 0;
+  pbnjson::JValue baseline_prev = pbnjson::Array();
+  pbnjson::JValue messages = sequence["messages"];
+  for (int i = 0; i < messages.arraySize(); ++i) {
+    pbnjson::JValue filtered;
+    bool expected_event = false;
+    if (FilterByBaseline(messages[i], running, filtered)) {
+      expected_event = (baseline_prev != filtered);
+      baseline_prev = filtered;
+    }
+
+    int events_before = s_events;
+    LSMSubscriber::instance().signal_foreground_info(messages[i]);
+    bool got_event = (s_events != events_before);
+
+    if (got_event != expected_event) {
+      ++failures;
+      fprintf(stderr, "message %d: expected %s, got %s\n", i,
+              expected_event ? "event" : "no event", got_event ? "event" : "no event");
+    } else if (got_event && s_last_event != filtered) {
+      ++failures;
+      fprintf(stderr, "message %d: event payload %s, expected %s\n", i,
+              JUtil::jsonToString(s_last_event).c_str(), JUtil::jsonToString(filtered).c_str());
+    }
+  }
+
+  printf("messages: %d, events: %d, failures: %d\n", messages.arraySize(), s_events, failures);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
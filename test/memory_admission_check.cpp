@@ -0,0 +1,233 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Check of memory admission in MemoryChecker4Base with fixture meminfo and
+// PSI files instead of /proc: launch is admitted, delayed until memory is
+// back, or admitted on timeout. Retries run on a real GLib main loop.
+//
+// usage: memory_admission_check data_dir
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "extensions/webos_base/base_settings.h"
+#include "extensions/webos_base/lifecycle/memory_checker_4_base.h"
+
+// defaults: footprint 51200 + min available 65536
+static const uint64_t REQUIRED_KB = 116736;
+static const uint64_t LOW_AVAILABLE_KB = 81920;   // meminfo_low
+static const uint64_t HIGH_AVAILABLE_KB = 1024000; // meminfo_high
+
+static int s_failures = 0;
+static std::string s_data_dir;
+static std::vector<std::string> s_done_uids;
+static std::vector<std::pair<std::string, uint64_t>> s_reclaims;
+static GMainLoop* s_loop = NULL;
+static std::string s_waited_uid;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      ++s_failures; \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while (0)
+
+static std::string Fixture(const char* name) {
+  return s_data_dir + "/" + name;
+}
+
+static bool IsDone(const std::string& uid) {
+  for (const std::string& done : s_done_uids) {
+    if (done == uid) return true;
+  }
+  return false;
+}
+
+static void OnCheckingDone(const std::string& uid) {
+  s_done_uids.push_back(uid);
+  if (s_loop && uid == s_waited_uid) g_main_loop_quit(s_loop);
+}
+
+static void OnReclaimRequired(const std::string& app_id, uint64_t required_kb) {
+  s_reclaims.push_back(std::make_pair(app_id, required_kb));
+}
+
+static gboolean OnGuardTimeout(gpointer user_data) {
+  g_main_loop_quit(s_loop);
+  return FALSE;
+}
+
+static gboolean OnMemoryFreed(gpointer user_data) {
+  BaseSettingsImpl::instance().meminfo_path_ = Fixture("meminfo_high");
+  return FALSE;
+}
+
+static gboolean OnPressureEased(gpointer user_data) {
+  BaseSettingsImpl::instance().memory_pressure_path_ = Fixture("pressure_calm");
+  return FALSE;
+}
+
+// runs main loop until uid is done, returns milliseconds it took
+static double WaitDone(const std::string& uid, guint guard_ms) {
+  gint64 start = g_get_monotonic_time();
+  if (!IsDone(uid)) {
+    s_waited_uid = uid;
+    s_loop = g_main_loop_new(NULL, FALSE);
+    guint guard = g_timeout_add(guard_ms, OnGuardTimeout, NULL);
+    g_main_loop_run(s_loop);
+    g_source_remove(guard);
+    g_main_loop_unref(s_loop);
+    s_loop = NULL;
+  }
+  return (g_get_monotonic_time() - start) / 1000.0;
+}
+
+static AppLaunchingItem4BasePtr NewItem(const std::string& app_id) {
+  return std::make_shared<AppLaunchingItem4Base>(app_id, AppLaunchRequestType::EXTERNAL,
+                                                 pbnjson::Object(), (LSMessage*) NULL);
+}
+
+static void Reset(const char* meminfo, const char* pressure) {
+  BaseSettings& settings = BaseSettingsImpl::instance();
+  settings.use_memory_admission_ = true;
+  settings.meminfo_path_ = Fixture(meminfo);
+  settings.memory_pressure_path_ = Fixture(pressure);
+  settings.memory_admission_retry_ms_ = 20;
+  settings.memory_admission_max_wait_ms_ = 10000;
+  settings.app_footprints_kb_.clear();
+  s_done_uids.clear();
+  s_reclaims.clear();
+}
+
+static void CheckAdmit(MemoryChecker4Base& checker) {
+
+  Reset("meminfo_high", "pressure_calm");
+  AppLaunchingItem4BasePtr item = NewItem("com.test.admit");
+  checker.add_item(item);
+  checker.run();
+  CHECK(IsDone(item->uid()));
+  CHECK(s_reclaims.empty());
+
+  // missing PSI is not a reason to delay, missing meminfo admits without checking
+  Reset("meminfo_high", "no_such_pressure");
+  item = NewItem("com.test.admit.nopsi");
+  checker.add_item(item);
+  checker.run();
+  CHECK(IsDone(item->uid()));
+
+  Reset("no_such_meminfo", "pressure_high");
+  item = NewItem("com.test.admit.nomeminfo");
+  checker.add_item(item);
+  checker.run();
+  CHECK(IsDone(item->uid()));
+  CHECK(s_reclaims.empty());
+}
+
+static void CheckDelayByMemory(MemoryChecker4Base& checker) {
+
+  Reset("meminfo_low", "pressure_calm");
+  AppLaunchingItem4BasePtr first = NewItem("com.test.delay.first");
+  AppLaunchingItem4BasePtr second = NewItem("com.test.delay.second");
+  checker.add_item(first);
+  checker.add_item(second);
+  checker.run();
+
+  // items are admitted in request order, so second one waits too
+  CHECK(!IsDone(first->uid()));
+  CHECK(!IsDone(second->uid()));
+  CHECK(s_reclaims.size() == 1);
+  CHECK(!s_reclaims.empty() && s_reclaims[0].first == first->app_id() &&
+        s_reclaims[0].second == REQUIRED_KB - LOW_AVAILABLE_KB);
+
+  g_timeout_add(100, OnMemoryFreed, NULL);
+  double waited_ms = WaitDone(second->uid(), 5000);
+  CHECK(IsDone(first->uid()));
+  CHECK(IsDone(second->uid()));
+  CHECK(s_done_uids.size() == 2 && s_done_uids[0] == first->uid());
+  CHECK(waited_ms >= 90);
+  // reclaim is requested once per delayed item
+  CHECK(s_reclaims.size() == 1);
+}
+
+static void CheckDelayByPressure(MemoryChecker4Base& checker) {
+
+  // under pressure without shortage, footprint of new app is reclaimed
+  Reset("meminfo_high", "pressure_high");
+  AppLaunchingItem4BasePtr item = NewItem("com.test.pressure");
+  checker.add_item(item);
+  checker.run();
+  CHECK(!IsDone(item->uid()));
+  CHECK(s_reclaims.size() == 1 && s_reclaims[0].second == 51200);
+
+  g_timeout_add(100, OnPressureEased, NULL);
+  double waited_ms = WaitDone(item->uid(), 5000);
+  CHECK(IsDone(item->uid()));
+  CHECK(waited_ms >= 90);
+
+  // configured footprint is used instead of default one
+  Reset("meminfo_high", "pressure_calm");
+  BaseSettingsImpl::instance().app_footprints_kb_["com.test.big"] = 2000000;
+  item = NewItem("com.test.big");
+  checker.add_item(item);
+  checker.run();
+  CHECK(!IsDone(item->uid()));
+  CHECK(s_reclaims.size() == 1 && s_reclaims[0].second == 2000000 + 65536 - HIGH_AVAILABLE_KB);
+  checker.cancel_all();
+  CHECK(IsDone(item->uid()));
+}
+
+static void CheckTimeout(MemoryChecker4Base& checker) {
+
+  // memory never comes back, launching is not blocked for good
+  Reset("meminfo_low", "pressure_high");
+  BaseSettingsImpl::instance().memory_admission_max_wait_ms_ = 200;
+  AppLaunchingItem4BasePtr item = NewItem("com.test.timeout");
+  checker.add_item(item);
+  checker.run();
+  CHECK(!IsDone(item->uid()));
+
+  double waited_ms = WaitDone(item->uid(), 5000);
+  CHECK(IsDone(item->uid()));
+  CHECK(waited_ms >= 180 && waited_ms < 5000);
+  CHECK(s_reclaims.size() == 1);
+}
+
+int main(int argc, char** argv) {
+
+  if (argc != 2) {
+    fprintf(stderr, "usage: %s data_dir\n", argv[0]);
+    return EXIT_FAILURE;
+  }
+  s_data_dir = argv[1];
+
+  MemoryChecker4Base checker;
+  checker.signal_memory_checking_done.connect(OnCheckingDone);
+  checker.signal_memory_reclaim_required.connect(OnReclaimRequired);
+
+  CheckAdmit(checker);
+  CheckDelayByMemory(checker);
+  CheckDelayByPressure(checker);
+  CheckTimeout(checker);
+
+  printf("failures: %d\n", s_failures);
+  return s_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,163 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Stress check of MimeSystem table lock.
+// Reader threads resolve resources, redirects and extensions and dump the
+// whole table while one writer thread keeps adding, changing and removing
+// the same handlers. Each query must see either no handler or the complete
+// handler, and the run must finish (a lock deadlock hangs until ctest timeout).
+//
+// usage: mime_system_stress [-r readers] [-n writer_rounds]
+
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "core/package/mime_system.h"
+
+static const char* STRESS_MIME = "application/x-sam-stress";
+static const char* STRESS_EXTENSION = "samstress";
+static const char* STRESS_RESOURCE_APP = "com.webos.app.stress.resource";
+static const char* STRESS_ALT_APP = "com.webos.app.stress.alternate";
+static const char* STRESS_URL_PATTERN = "^http://stress\\.sam\\.test/";
+static const char* STRESS_URL = "http://stress.sam.test/page";
+static const char* STRESS_REDIRECT_APP = "com.webos.app.stress.redirect";
+
+static volatile gint s_writerDone = 0;
+static volatile gint s_failures = 0;
+static volatile gint s_queries = 0;
+
+static void Fail(const char* what, const std::string& value) {
+  g_atomic_int_inc(&s_failures);
+  fprintf(stderr, "unexpected %s: '%s'\n", what, value.c_str());
+}
+
+static bool IsStressApp(const std::string& app_id) {
+  return app_id == STRESS_RESOURCE_APP || app_id == STRESS_ALT_APP;
+}
+
+static gpointer ReaderThread(gpointer data) {
+
+  MimeSystem& mime = MimeSystemImpl::instance();
+  while (!g_atomic_int_get(&s_writerDone)) {
+    std::string app_id = mime.getActiveAppIdForResource(STRESS_MIME);
+    if (!app_id.empty() && !IsStressApp(app_id))
+      Fail("resource handler", app_id);
+
+    std::string active;
+    std::vector<std::string> handlers;
+    mime.getAllAppIdForResource(STRESS_MIME, active, handlers);
+    for (const std::string& handler : handlers) {
+      if (!IsStressApp(handler)) Fail("alternate resource handler", handler);
+    }
+
+    app_id = mime.getActiveAppIdForRedirect(STRESS_URL, false, false);
+    if (!app_id.empty() && app_id != STRESS_REDIRECT_APP)
+      Fail("redirect handler", app_id);
+
+    std::string mime_type;
+    if (mime.getMimeTypeByExtension(STRESS_EXTENSION, mime_type) && mime_type != STRESS_MIME)
+      Fail("mime type", mime_type);
+
+    // nested read locks inside the table dump
+    std::string table = mime.allTablesAsJsonString();
+    if (table.empty()) Fail("table dump", table);
+
+    g_atomic_int_inc(&s_queries);
+  }
+  return NULL;
+}
+
+static gpointer WriterThread(gpointer data) {
+
+  MimeSystem& mime = MimeSystemImpl::instance();
+  int rounds = GPOINTER_TO_INT(data);
+  std::map<std::string, std::string> verbs;
+  verbs["stress"] = "{}";
+
+  for (int i = 0; i < rounds; ++i) {
+    std::string extension = STRESS_EXTENSION;
+    mime.addResourceHandler(extension, STRESS_MIME, false, STRESS_RESOURCE_APP, NULL, false);
+    mime.addResourceHandler(extension, STRESS_MIME, false, STRESS_ALT_APP, NULL, false);
+    mime.addRedirectHandler(STRESS_URL_PATTERN, STRESS_REDIRECT_APP, NULL, false, false);
+    mime.addVerbsToResourceHandler(STRESS_MIME, STRESS_RESOURCE_APP, verbs);
+    mime.addVerbsToRedirectHandler(STRESS_URL_PATTERN, STRESS_REDIRECT_APP, verbs);
+
+    // swap active resource handler to alternate one and back
+    ResourceHandler active;
+    std::vector<ResourceHandler> alternates;
+    mime.getAllHandlersForResource(STRESS_MIME, active, alternates);
+    if (!alternates.empty()) {
+      mime.swapResourceHandler(STRESS_MIME, alternates.front().index());
+    }
+
+    mime.removeAllForAppId(STRESS_ALT_APP);
+    if (i % 2 == 0) {
+      mime.removeAllForMimeType(STRESS_MIME);
+      mime.removeAllForUrl(STRESS_URL_PATTERN);
+    } else {
+      mime.removeAllForAppId(STRESS_RESOURCE_APP);
+      mime.removeAllForAppId(STRESS_REDIRECT_APP);
+    }
+  }
+
+  g_atomic_int_set(&s_writerDone, 1);
+  return NULL;
+}
+
+int main(int argc, char** argv) {
+
+  int readers = 4;
+  int rounds = 2000;
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "r:n:")) != -1) {
+    switch (opt) {
+      case 'r': readers = atoi(optarg); break;
+      case 'n': rounds = atoi(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-r readers] [-n writer_rounds]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (readers <= 0 || rounds <= 0) {
+    fprintf(stderr, "readers and rounds must be positive\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<GThread*> threads;
+  for (int i = 0; i < readers; ++i)
+    threads.push_back(g_thread_new("mime_reader", ReaderThread, NULL));
+  threads.push_back(g_thread_new("mime_writer", WriterThread, GINT_TO_POINTER(rounds)));
+
+  for (GThread* thread : threads)
+    g_thread_join(thread);
+
+  // tables are left without stress entries
+  std::string app_id = MimeSystemImpl::instance().getActiveAppIdForResource(STRESS_MIME);
+  if (!app_id.empty()) Fail("resource handler after removal", app_id);
+  app_id = MimeSystemImpl::instance().getActiveAppIdForRedirect(STRESS_URL, false, false);
+  if (!app_id.empty()) Fail("redirect handler after removal", app_id);
+
+  int failures = g_atomic_int_get(&s_failures);
+  printf("readers: %d, writer rounds: %d, queries: %d, failures: %d\n",
+         readers, rounds, g_atomic_int_get(&s_queries), failures);
+  return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
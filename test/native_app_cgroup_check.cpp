@@ -0,0 +1,186 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Check of NativeAppCgroup against a fake cgroup v2 hierarchy in a temp dir.
+// Kernel interface files (cgroup.controllers, cgroup.procs, cgroup.kill) are
+// plain files here, created by this program where kernel would create them,
+// so what NativeAppCgroup writes and reads can be inspected.
+//
+// usage: native_app_cgroup_check
+
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "core/lifecycle/life_handler/native_app_cgroup.h"
+
+static int s_failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      ++s_failures; \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+    } \
+  } while (0)
+
+static bool Exists(const std::string& path) {
+  return access(path.c_str(), F_OK) == 0;
+}
+
+static void MakeFile(const std::string& path, const std::string& content) {
+  std::ofstream file(path.c_str());
+  file << content;
+}
+
+static std::string ReadFile(const std::string& path) {
+  std::ifstream file(path.c_str());
+  std::stringstream content;
+  content << file.rdbuf();
+  return content.str();
+}
+
+// kernel creates interface files in every new group
+static void PopulateGroup(const std::string& procs_path, bool with_kill) {
+  std::string group = procs_path.substr(0, procs_path.rfind('/'));
+  MakeFile(group + "/cgroup.controllers", "");
+  MakeFile(procs_path, "");
+  if (with_kill) MakeFile(group + "/cgroup.kill", "");
+}
+
+static int RemoveEntry(const char* path, const struct stat* sb, int flag, struct FTW* ftw) {
+  return remove(path);
+}
+
+static void CheckNotCgroup2(const std::string& tmp_dir) {
+
+  // plain directory is not a cgroup v2 hierarchy, created root is removed again
+  std::string root = tmp_dir + "/plain";
+  CHECK(!NativeAppCgroup::instance().Init(root));
+  CHECK(!NativeAppCgroup::instance().IsEnabled());
+  CHECK(!Exists(root));
+  CHECK(NativeAppCgroup::instance().Prepare("uid-plain").empty());
+  CHECK(!NativeAppCgroup::instance().Attach(100, root + "/uid-plain/cgroup.procs"));
+}
+
+static void CheckWithoutKill(const std::string& tmp_dir) {
+
+  std::string root = tmp_dir + "/nokill";
+  CHECK(mkdir(root.c_str(), 0755) == 0);
+  MakeFile(root + "/cgroup.controllers", "cpu memory pids");
+  // empty group left by previous sam process
+  CHECK(mkdir((root + "/stale-uid").c_str(), 0755) == 0);
+
+  CHECK(NativeAppCgroup::instance().Init(root + "/"));
+  CHECK(NativeAppCgroup::instance().IsEnabled());
+  CHECK(!Exists(root + "/stale-uid"));
+
+  CHECK(NativeAppCgroup::instance().Prepare("").empty());
+
+  // group without cgroup.procs cannot be attached, and it is discarded
+  std::string procs_path = NativeAppCgroup::instance().Prepare("uid-1");
+  CHECK(procs_path == root + "/uid-1/cgroup.procs");
+  CHECK(Exists(root + "/uid-1"));
+  CHECK(!NativeAppCgroup::instance().Attach(1001, procs_path));
+  CHECK(!Exists(root + "/uid-1"));
+
+  procs_path = NativeAppCgroup::instance().Prepare("uid-2");
+  PopulateGroup(procs_path, false);
+  CHECK(!NativeAppCgroup::instance().Attach(0, procs_path));
+  CHECK(NativeAppCgroup::instance().Attach(1002, procs_path));
+  CHECK(ReadFile(procs_path) == "1002");
+
+  // forked children joined group, main pid comes first
+  MakeFile(procs_path, "2001\n1002\n2002\n");
+  std::vector<pid_t> pids;
+  CHECK(NativeAppCgroup::instance().GetPids(1002, pids));
+  CHECK(pids.size() == 3);
+  CHECK(pids.size() == 3 && pids[0] == 1002 && pids[1] == 2001 && pids[2] == 2002);
+
+  pids.clear();
+  CHECK(!NativeAppCgroup::instance().GetPids(9999, pids));
+  CHECK(pids.empty());
+
+  // without cgroup.kill caller falls back to signals
+  CHECK(!NativeAppCgroup::instance().Kill(1002));
+
+  NativeAppCgroup::instance().Remove(1002);
+  pids.clear();
+  CHECK(!NativeAppCgroup::instance().GetPids(1002, pids));
+}
+
+static void CheckWithKill(const std::string& tmp_dir) {
+
+  std::string root = tmp_dir + "/kill";
+  CHECK(mkdir(root.c_str(), 0755) == 0);
+  MakeFile(root + "/cgroup.controllers", "cpu memory pids");
+  MakeFile(root + "/cgroup.kill", "");
+
+  CHECK(NativeAppCgroup::instance().Init(root));
+  CHECK(NativeAppCgroup::instance().IsEnabled());
+
+  std::string procs_path = NativeAppCgroup::instance().Prepare("uid-3");
+  CHECK(procs_path == root + "/uid-3/cgroup.procs");
+  PopulateGroup(procs_path, true);
+
+  // g_spawn child_setup writes "0", meaning the writing process itself
+  NativeAppCgroup::EnterInChild((void*) procs_path.c_str());
+  CHECK(ReadFile(procs_path) == "0");
+  NativeAppCgroup::EnterInChild(NULL);
+
+  MakeFile(procs_path, "");
+  CHECK(NativeAppCgroup::instance().Attach(1003, procs_path));
+  CHECK(NativeAppCgroup::instance().Kill(1003));
+  CHECK(ReadFile(root + "/uid-3/cgroup.kill") == "1");
+  CHECK(!NativeAppCgroup::instance().Kill(9999));
+
+  // group which is still busy is removed later, on next Prepare
+  NativeAppCgroup::instance().Remove(1003);
+  CHECK(Exists(root + "/uid-3"));
+  unlink((root + "/uid-3/cgroup.controllers").c_str());
+  unlink((root + "/uid-3/cgroup.kill").c_str());
+  unlink(procs_path.c_str());
+  (void) NativeAppCgroup::instance().Prepare("uid-4");
+  CHECK(!Exists(root + "/uid-3"));
+  CHECK(Exists(root + "/uid-4"));
+}
+
+int main(int argc, char** argv) {
+
+  char tmp_template[] = "/tmp/sam-cgroup-XXXXXX";
+  char* tmp_dir = mkdtemp(tmp_template);
+  if (tmp_dir == NULL) {
+    perror("mkdtemp");
+    return EXIT_FAILURE;
+  }
+
+  CheckNotCgroup2(tmp_dir);
+  CheckWithoutKill(tmp_dir);
+  CheckWithKill(tmp_dir);
+
+  (void) nftw(tmp_dir, RemoveEntry, 16, FTW_DEPTH | FTW_PHYS);
+
+  printf("failures: %d\n", s_failures);
+  return s_failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,210 @@
+// Copyright (c) 2018 LG Electronics, Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// SPDX-License-Identifier: Apache-2.0
+
+// Standalone timing tool for native app launch paths.
+// It launches a dummy binary repeatedly through NativeAppZygote (fork from
+// pre-forked helper, binary kept in page cache by posix_fadvise), posix_spawn
+// and g_spawn_async, and prints how long each launch call and each launch
+// until process exit take.
+//
+// usage: sam-launch-timing [-n runs] [-m ballast_mb] [binary [args...]]
+//   -n runs        launches per method (default 100)
+//   -m ballast_mb  memory touched by this process after helper is started,
+//                  to see fork cost of grown sam (default 0)
+//   binary         dummy binary to launch (default /bin/true)
+
+#include <errno.h>
+#include <glib.h>
+#include <poll.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/lifecycle/life_handler/native_app_zygote.h"
+
+extern char** environ;
+
+struct Timing {
+  std::vector<double> launch_us_;
+  std::vector<double> exit_us_;
+};
+
+static double NowUs() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static void WaitChild(pid_t pid) {
+  while (waitpid(pid, NULL, 0) < 0 && errno == EINTR) {}
+}
+
+static bool LaunchByZygote(const char** argv, Timing& timing) {
+
+  int pidfd = -1;
+  double start = NowUs();
+  pid_t pid = NativeAppZygote::instance().Launch(argv, (const char**) environ, "", pidfd);
+  double launched = NowUs();
+  if (pid <= 0 || pidfd < 0) return false;
+
+  // launched process is child of helper, so its exit is seen through pidfd
+  struct pollfd pfd = { pidfd, POLLIN, 0 };
+  while (poll(&pfd, 1, -1) < 0 && errno == EINTR) {}
+  double exited = NowUs();
+  close(pidfd);
+
+  timing.launch_us_.push_back(launched - start);
+  timing.exit_us_.push_back(exited - start);
+  return true;
+}
+
+static bool LaunchByPosixSpawn(const char** argv, Timing& timing) {
+
+  pid_t pid = -1;
+  double start = NowUs();
+  int result = posix_spawn(&pid, argv[0], NULL, NULL, (char* const*) argv, environ);
+  double launched = NowUs();
+  if (result != 0) return false;
+
+  WaitChild(pid);
+  double exited = NowUs();
+
+  timing.launch_us_.push_back(launched - start);
+  timing.exit_us_.push_back(exited - start);
+  return true;
+}
+
+static bool LaunchByGSpawn(const char** argv, Timing& timing) {
+
+  GPid pid = -1;
+  GError* error = NULL;
+  double start = NowUs();
+  gboolean result = g_spawn_async(NULL, (gchar**) argv, NULL, G_SPAWN_DO_NOT_REAP_CHILD,
+                                  NULL, NULL, &pid, &error);
+  double launched = NowUs();
+  if (!result) {
+    if (error) g_error_free(error);
+    return false;
+  }
+
+  WaitChild(pid);
+  double exited = NowUs();
+  g_spawn_close_pid(pid);
+
+  timing.launch_us_.push_back(launched - start);
+  timing.exit_us_.push_back(exited - start);
+  return true;
+}
+
+static void PrintStats(const char* label, std::vector<double> values) {
+
+  if (values.empty()) {
+    printf("  %-8s %10s\n", label, "n/a");
+    return;
+  }
+
+  std::sort(values.begin(), values.end());
+  double sum = 0;
+  for (double value : values) sum += value;
+
+  printf("  %-8s %10.1f %10.1f %10.1f %10.1f\n", label,
+         sum / values.size(), values.front(), values[values.size() / 2], values.back());
+}
+
+static void PrintTiming(const char* method, const Timing& timing, int runs) {
+
+  printf("%s (%d/%d runs succeeded)\n", method, (int) timing.launch_us_.size(), runs);
+  printf("  %-8s %10s %10s %10s %10s\n", "us", "avg", "min", "median", "max");
+  PrintStats("launch", timing.launch_us_);
+  PrintStats("exit", timing.exit_us_);
+}
+
+int main(int argc, char** argv) {
+
+  int runs = 100;
+  long ballast_mb = 0;
+  int opt = 0;
+  while ((opt = getopt(argc, argv, "+n:m:")) != -1) {
+    switch (opt) {
+      case 'n': runs = atoi(optarg); break;
+      case 'm': ballast_mb = atol(optarg); break;
+      default:
+        fprintf(stderr, "usage: %s [-n runs] [-m ballast_mb] [binary [args...]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+  }
+  if (runs <= 0 || ballast_mb < 0) {
+    fprintf(stderr, "runs must be positive and ballast must not be negative\n");
+    return EXIT_FAILURE;
+  }
+
+  std::vector<const char*> dummy_argv;
+  if (optind < argc) {
+    for (int i = optind; i < argc; ++i) dummy_argv.push_back(argv[i]);
+  } else {
+    dummy_argv.push_back("/bin/true");
+  }
+  dummy_argv.push_back(NULL);
+
+  // helper is started while this process is small, same as sam does at init
+  std::vector<std::string> warm_paths(1, dummy_argv[0]);
+  bool zygote_started = NativeAppZygote::instance().Start(warm_paths);
+  if (!zygote_started) {
+    fprintf(stderr, "zygote helper is not available (pidfd is required), its timing is skipped\n");
+  }
+
+  char* ballast = NULL;
+  if (ballast_mb > 0) {
+    size_t size = (size_t) ballast_mb * 1024 * 1024;
+    ballast = (char*) malloc(size);
+    if (ballast == NULL) {
+      fprintf(stderr, "failed to allocate %ld MB ballast\n", ballast_mb);
+      return EXIT_FAILURE;
+    }
+    memset(ballast, 1, size);
+  }
+
+  printf("binary: %s, runs: %d, ballast: %ld MB\n\n", dummy_argv[0], runs, ballast_mb);
+
+  // first launch of each method is not counted, it pulls binary into page cache
+  Timing zygote, posix, gspawn, warmup;
+  if (zygote_started) (void) LaunchByZygote(dummy_argv.data(), warmup);
+  (void) LaunchByPosixSpawn(dummy_argv.data(), warmup);
+  (void) LaunchByGSpawn(dummy_argv.data(), warmup);
+
+  // methods take turns, so changes of system load hit all of them alike
+  for (int i = 0; i < runs; ++i) {
+    if (zygote_started) (void) LaunchByZygote(dummy_argv.data(), zygote);
+    (void) LaunchByPosixSpawn(dummy_argv.data(), posix);
+    (void) LaunchByGSpawn(dummy_argv.data(), gspawn);
+  }
+
+  if (zygote_started) PrintTiming("zygote", zygote, runs);
+  PrintTiming("posix_spawn", posix, runs);
+  PrintTiming("g_spawn", gspawn, runs);
+
+  NativeAppZygote::instance().Stop();
+  free(ballast);
+  return EXIT_SUCCESS;
+}